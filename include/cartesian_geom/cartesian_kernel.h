@@ -24,13 +24,17 @@
 
 #include "point.h"
 
-template <typename K>
+// The dimension D is a compile-time constant for small fixed dimensions,
+// then the coordinates of the points are stored in fixed-size, stack
+// allocated Eigen vectors. Eigen::Dynamic (default) keeps them on the heap.
+template <typename K, int D = Eigen::Dynamic>
 class Cartesian
 {
 public:
-  typedef Cartesian<K> Self;
+  typedef Cartesian<K, D> Self;
   typedef K                    FT;
   typedef point<Self>              Point;
+  enum { Dim = D };
 
 };
 
@@ -19,10 +19,10 @@ class point
 private:
     unsigned int d;
 
-    Eigen::Matrix<typename K::FT, Eigen::Dynamic,1> coeffs;
+    Eigen::Matrix<typename K::FT, K::Dim, 1> coeffs;
     typedef typename std::vector<typename K::FT>::iterator iter;
 public:
-    typedef Eigen::Matrix<typename K::FT, Eigen::Dynamic,1> Coeff;
+    typedef Eigen::Matrix<typename K::FT, K::Dim, 1> Coeff;
     typedef typename K::FT 	FT;
 
     point() {}
@@ -61,7 +61,8 @@ public:
 
     }
 
-    void add(const Coeff& coeffs)
+    template <typename Derived>
+    void add(const Eigen::MatrixBase<Derived>& coeffs)
     {
         this->coeffs += coeffs;
     }
@@ -109,14 +110,30 @@ public:
         return coeffs.sum();
     }
 
+    // The in-place operators accept any Eigen expression, e.g.
+    // p += lambda * v.getCoefficients(), which is evaluated directly into
+    // the coefficients of p without any temporary. They should be preferred
+    // over the operators +,-,* that return a new point in the inner loops.
     void operator+= (const point& p)
     {
         coeffs += p.getCoefficients();
     }
 
-    void operator+= (const Coeff& coeffs)
+    template <typename Derived>
+    void operator+= (const Eigen::MatrixBase<Derived>& coeffs)
     {
-        this->coeffs = coeffs + this->coeffs;
+        this->coeffs += coeffs;
+    }
+
+    void operator-= (const point& p)
+    {
+        coeffs -= p.getCoefficients();
+    }
+
+    template <typename Derived>
+    void operator-= (const Eigen::MatrixBase<Derived>& coeffs)
+    {
+        this->coeffs -= coeffs;
     }
 
     void operator= (const Coeff& coeffs)
@@ -125,7 +142,6 @@ public:
         d = coeffs.rows();
     }
 
-    //TODO: avoid point construction in operators +,-,*
     point operator+ (const point& p) const
     {
         point temp;
@@ -186,7 +202,8 @@ public:
         return coeffs.dot(p.getCoefficients());
     }
 
-    FT dot(const Coeff& coeffs) const
+    template <typename Derived>
+    FT dot(const Eigen::MatrixBase<Derived>& coeffs) const
     {
         return this->coeffs.dot(coeffs);
     }
@@ -12,6 +12,7 @@
 #ifndef BALL_H
 #define BALL_H
 
+#include <vector>
 #include <Eigen/Eigen>
 
 // ball type
@@ -60,6 +61,16 @@ public:
         else return 0;
     }
 
+    // is_in for each column of X
+    template <typename MatrixType>
+    void is_in(MatrixType const& X, std::vector<int>& in) const
+    {
+        in.resize(X.cols());
+        for (int j = 0; j < X.cols(); j++) {
+            in[j] = (X.col(j).squaredNorm() <= R) ? -1 : 0;
+        }
+    }
+
     std::pair<NT,NT> line_intersect(Point const& r, Point const& v) const
     {
 
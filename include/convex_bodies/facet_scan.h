@@ -0,0 +1,250 @@
+// VolEsti (volume computation and sampling library)
+
+// Copyright (c) 2012-2020 Vissarion Fisikopoulos
+// Copyright (c) 2018-2020 Apostolos Chalkis
+
+// Licensed under GNU LGPL.3, see LICENCE file
+
+#ifndef FACET_SCAN_H
+#define FACET_SCAN_H
+
+#include <limits>
+
+// x86 SIMD kernels, selected at runtime; define VOLESTI_NO_SIMD to disable
+#if !defined(VOLESTI_NO_SIMD) && defined(__GNUC__) \
+    && (defined(__x86_64__) || defined(__i386__))
+    #define VOLESTI_FACET_SCAN_X86
+    #include <immintrin.h>
+#endif
+
+
+// The boundary oracles of an H-polytope scan the ratios
+// lambda_i = (nom_i - sub_i) / denom_i, i = 0,...,m-1 (lambda_i = nom_i / denom_i
+// when sub is NULL) for the minimum positive ratio min_plus, the first facet
+// that attains it and the maximum negative ratio max_minus.
+// The kernels are branch-free: a zero denominator gives lambda_i = +-inf or nan
+// that is never selected, thus these facets are ignored as in the oracles.
+// If no ratio is positive (negative) then min_plus (max_minus) is
+// std::numeric_limits<NT>::max() (lowest()) and facet is -1.
+
+template <typename NT>
+inline void facet_scan_scalar(NT const* nom,
+                              NT const* sub,
+                              NT const* denom,
+                              int const& m,
+                              NT& min_plus,
+                              NT& max_minus,
+                              int& facet)
+{
+    const NT max = std::numeric_limits<NT>::max();
+    const NT lowest = std::numeric_limits<NT>::lowest();
+    min_plus = max;
+    max_minus = lowest;
+    facet = -1;
+
+    for (int i = 0; i < m; i++)
+    {
+        NT lamda = (sub == NULL) ? nom[i] / denom[i]
+                                 : (nom[i] - sub[i]) / denom[i];
+        NT pos = (lamda > NT(0)) ? lamda : max;
+        NT neg = (lamda < NT(0)) ? lamda : lowest;
+        facet = (pos < min_plus) ? i : facet;
+        min_plus = (pos < min_plus) ? pos : min_plus;
+        max_minus = (neg > max_minus) ? neg : max_minus;
+    }
+}
+
+
+#ifdef VOLESTI_FACET_SCAN_X86
+
+// merge the per lane results of a SIMD kernel and scan the remaining ratios
+inline void facet_scan_reduce(double const* mins,
+                              double const* idxs,
+                              double const* maxs,
+                              int const& lanes,
+                              double const* nom,
+                              double const* sub,
+                              double const* denom,
+                              int const& start,
+                              int const& m,
+                              double& min_plus,
+                              double& max_minus,
+                              int& facet)
+{
+    min_plus = std::numeric_limits<double>::max();
+    max_minus = std::numeric_limits<double>::lowest();
+    facet = -1;
+
+    for (int l = 0; l < lanes; l++)
+    {
+        int idx = int(idxs[l]);
+        if (mins[l] < min_plus || (mins[l] == min_plus && idx >= 0 && idx < facet))
+        {
+            min_plus = mins[l];
+            facet = idx;
+        }
+        if (maxs[l] > max_minus) max_minus = maxs[l];
+    }
+
+    double tail_min_plus, tail_max_minus;
+    int tail_facet;
+    facet_scan_scalar(nom + start, (sub == NULL) ? sub : sub + start,
+                      denom + start, m - start,
+                      tail_min_plus, tail_max_minus, tail_facet);
+    if (tail_min_plus < min_plus)
+    {
+        min_plus = tail_min_plus;
+        facet = start + tail_facet;
+    }
+    if (tail_max_minus > max_minus) max_minus = tail_max_minus;
+}
+
+__attribute__((target("avx2")))
+inline void facet_scan_avx2(double const* nom,
+                            double const* sub,
+                            double const* denom,
+                            int const& m,
+                            double& min_plus,
+                            double& max_minus,
+                            int& facet)
+{
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d max = _mm256_set1_pd(std::numeric_limits<double>::max());
+    const __m256d lowest = _mm256_set1_pd(std::numeric_limits<double>::lowest());
+    const __m256d step = _mm256_set1_pd(4.0);
+    __m256d vmin = max, vmax = lowest, vidx = _mm256_set1_pd(-1.0);
+    __m256d idx = _mm256_set_pd(3.0, 2.0, 1.0, 0.0);
+
+    int i = 0;
+    for (; i + 4 <= m; i += 4)
+    {
+        __m256d x = _mm256_loadu_pd(nom + i);
+        if (sub != NULL) x = _mm256_sub_pd(x, _mm256_loadu_pd(sub + i));
+        __m256d lamda = _mm256_div_pd(x, _mm256_loadu_pd(denom + i));
+
+        __m256d pos = _mm256_blendv_pd(max, lamda,
+                                       _mm256_cmp_pd(lamda, zero, _CMP_GT_OQ));
+        __m256d less = _mm256_cmp_pd(pos, vmin, _CMP_LT_OQ);
+        vmin = _mm256_blendv_pd(vmin, pos, less);
+        vidx = _mm256_blendv_pd(vidx, idx, less);
+
+        __m256d neg = _mm256_blendv_pd(lowest, lamda,
+                                       _mm256_cmp_pd(lamda, zero, _CMP_LT_OQ));
+        vmax = _mm256_max_pd(vmax, neg);
+        idx = _mm256_add_pd(idx, step);
+    }
+
+    double mins[4], idxs[4], maxs[4];
+    _mm256_storeu_pd(mins, vmin);
+    _mm256_storeu_pd(idxs, vidx);
+    _mm256_storeu_pd(maxs, vmax);
+    facet_scan_reduce(mins, idxs, maxs, 4, nom, sub, denom, i, m,
+                      min_plus, max_minus, facet);
+}
+
+__attribute__((target("avx512f")))
+inline void facet_scan_avx512(double const* nom,
+                              double const* sub,
+                              double const* denom,
+                              int const& m,
+                              double& min_plus,
+                              double& max_minus,
+                              int& facet)
+{
+    const __m512d zero = _mm512_setzero_pd();
+    const __m512d max = _mm512_set1_pd(std::numeric_limits<double>::max());
+    const __m512d lowest = _mm512_set1_pd(std::numeric_limits<double>::lowest());
+    const __m512d step = _mm512_set1_pd(8.0);
+    __m512d vmin = max, vmax = lowest, vidx = _mm512_set1_pd(-1.0);
+    __m512d idx = _mm512_set_pd(7.0, 6.0, 5.0, 4.0, 3.0, 2.0, 1.0, 0.0);
+
+    int i = 0;
+    for (; i + 8 <= m; i += 8)
+    {
+        __m512d x = _mm512_loadu_pd(nom + i);
+        if (sub != NULL) x = _mm512_sub_pd(x, _mm512_loadu_pd(sub + i));
+        __m512d lamda = _mm512_div_pd(x, _mm512_loadu_pd(denom + i));
+
+        __m512d pos = _mm512_mask_blend_pd(
+                _mm512_cmp_pd_mask(lamda, zero, _CMP_GT_OQ), max, lamda);
+        __mmask8 less = _mm512_cmp_pd_mask(pos, vmin, _CMP_LT_OQ);
+        vmin = _mm512_mask_blend_pd(less, vmin, pos);
+        vidx = _mm512_mask_blend_pd(less, vidx, idx);
+
+        __m512d neg = _mm512_mask_blend_pd(
+                _mm512_cmp_pd_mask(lamda, zero, _CMP_LT_OQ), lowest, lamda);
+        vmax = _mm512_max_pd(vmax, neg);
+        idx = _mm512_add_pd(idx, step);
+    }
+
+    double mins[8], idxs[8], maxs[8];
+    _mm512_storeu_pd(mins, vmin);
+    _mm512_storeu_pd(idxs, vidx);
+    _mm512_storeu_pd(maxs, vmax);
+    facet_scan_reduce(mins, idxs, maxs, 8, nom, sub, denom, i, m,
+                      min_plus, max_minus, facet);
+}
+
+enum facet_scan_isa { FACET_SCAN_SCALAR, FACET_SCAN_AVX2, FACET_SCAN_AVX512 };
+
+// the widest instruction set supported by the cpu, detected once
+inline facet_scan_isa get_facet_scan_isa()
+{
+    static const facet_scan_isa isa = []()
+    {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f")) return FACET_SCAN_AVX512;
+        if (__builtin_cpu_supports("avx2")) return FACET_SCAN_AVX2;
+        return FACET_SCAN_SCALAR;
+    }();
+    return isa;
+}
+
+#endif // VOLESTI_FACET_SCAN_X86
+
+
+template <typename NT>
+struct FacetScan
+{
+    static inline void apply(NT const* nom,
+                             NT const* sub,
+                             NT const* denom,
+                             int const& m,
+                             NT& min_plus,
+                             NT& max_minus,
+                             int& facet)
+    {
+        facet_scan_scalar(nom, sub, denom, m, min_plus, max_minus, facet);
+    }
+};
+
+#ifdef VOLESTI_FACET_SCAN_X86
+
+template <>
+struct FacetScan<double>
+{
+    static inline void apply(double const* nom,
+                             double const* sub,
+                             double const* denom,
+                             int const& m,
+                             double& min_plus,
+                             double& max_minus,
+                             int& facet)
+    {
+        switch (get_facet_scan_isa())
+        {
+            case FACET_SCAN_AVX512:
+                facet_scan_avx512(nom, sub, denom, m, min_plus, max_minus, facet);
+                break;
+            case FACET_SCAN_AVX2:
+                facet_scan_avx2(nom, sub, denom, m, min_plus, max_minus, facet);
+                break;
+            default:
+                facet_scan_scalar(nom, sub, denom, m, min_plus, max_minus, facet);
+        }
+    }
+};
+
+#endif // VOLESTI_FACET_SCAN_X86
+
+#endif // FACET_SCAN_H
@@ -14,8 +14,10 @@
 
 #include <limits>
 #include <iostream>
+#include <vector>
 #include <Eigen/Eigen>
 #include "preprocess/max_inscribed_ball.hpp"
+#include "convex_bodies/facet_scan.h"
 #ifndef VOLESTIPY
     #include "lp_oracles/solve_lp.h"
 #endif
@@ -281,44 +283,93 @@ public:
         return -1;
     }
 
+    // is_in for each column of X with one product A*X,
+    // in[j] is -1 if the j-th column is in P and 0 otherwise
+    template <typename MatrixType>
+    void is_in(MatrixType const& X, std::vector<int>& in, NT tol=NT(0)) const
+    {
+        in.resize(X.cols());
+        MT slacks = (A * X).colwise() - b;
+        for (int j = 0; j < X.cols(); j++) {
+            in[j] = (slacks.col(j).maxCoeff() > tol) ? 0 : -1;
+        }
+    }
+
     // compute intersection point of ray starting from r and pointing to v
     // with polytope discribed by A and b
     std::pair<NT,NT> line_intersect(Point const& r, Point const& v) const
     {
-
-        NT lamda = 0;
-        NT min_plus  = std::numeric_limits<NT>::max();
-        NT max_minus = std::numeric_limits<NT>::lowest();
+        NT min_plus, max_minus;
+        int facet;
         VT sum_nom, sum_denom;
-        //unsigned int i, j;
-        unsigned int j;
-        int m = num_of_hyperplanes();
-
 
         sum_nom.noalias() = b - A * r.getCoefficients();
         sum_denom.noalias() = A * v.getCoefficients();
 
-        NT* sum_nom_data = sum_nom.data();
-        NT* sum_denom_data = sum_denom.data();
+        FacetScan<NT>::apply(sum_nom.data(), NULL, sum_denom.data(),
+                             num_of_hyperplanes(), min_plus, max_minus, facet);
+        return std::make_pair(min_plus, max_minus);
+    }
 
-        for (int i = 0; i < m; i++) {
+    // compute intersection points of K rays with polytope discribed by A and b,
+    // the i-th ray starts from R.col(i) and points to V.col(i)
+    // both A*R and A*V are computed by a single matrix-matrix product
+    std::pair<VT,VT> line_intersect(MT const& R, MT const& V) const
+    {
+        MT AR, AV;
+        return line_intersect(R, V, AR, AV);
+    }
 
-            if (*sum_denom_data == NT(0)) {
-                //std::cout<<"div0"<<std::endl;
-                ;
-            } else {
-                lamda = *sum_nom_data / *sum_denom_data;
-                if (lamda < min_plus && lamda > 0) min_plus = lamda;
-                if (lamda > max_minus && lamda < 0) max_minus = lamda;
-            }
+    // as above but also return A*R and A*V in AR and AV (m x K)
+    std::pair<VT,VT> line_intersect(MT const& R,
+                                    MT const& V,
+                                    MT& AR,
+                                    MT& AV) const
+    {
+        typedef Eigen::Array<NT, Eigen::Dynamic, Eigen::Dynamic> AT;
 
-            sum_nom_data++;
-            sum_denom_data++;
-        }
-        return std::make_pair(min_plus, max_minus);
+        int K = R.cols();
+        MT RV(_d, 2 * K), ARV;
+        RV << R, V;
+        ARV.noalias() = A * RV;
+        AR = ARV.leftCols(K);
+        AV = ARV.rightCols(K);
+
+        // lambdas are (b_i - A_i*r) / (A_i*v), zero denominators are ignored
+        AT lambdas = (-AR).array().colwise() + b.array();
+        lambdas /= AV.array();
+        auto valid = AV.array() != NT(0);
+
+        std::pair<VT,VT> res;
+        res.first = (valid && lambdas > NT(0))
+                .select(lambdas, std::numeric_limits<NT>::max())
+                .colwise().minCoeff().transpose();
+        res.second = (valid && lambdas < NT(0))
+                .select(lambdas, std::numeric_limits<NT>::lowest())
+                .colwise().maxCoeff().transpose();
+        return res;
+    }
+
+    // compute A*V for a batch of vectors stored in the columns of V
+    void compute_AV(MT const& V, MT& AV) const
+    {
+        AV.noalias() = A * V;
     }
 
-    // compute intersection points of a ray starting from r and pointing to v
+    // compute intersection point of the ray of the j-th chain with the boundary
+    // when A*r and A*v are stored in the j-th column of AR and AV respectively
+    std::pair<NT, int> line_positive_intersect(MT const& AR,
+                                               MT const& AV,
+                                               int const& j) const
+    {
+        NT min_plus, max_minus;
+        int facet;
+        FacetScan<NT>::apply(b.data(), AR.col(j).data(), AV.col(j).data(),
+                             num_of_hyperplanes(), min_plus, max_minus, facet);
+        return std::pair<NT, int>(min_plus, facet);
+    }
+
+    // compute intersection point of a ray starting from r and pointing to v
     // with polytope discribed by A and b
     std::pair<NT,NT> line_intersect(Point const& r,
                                     Point const& v,
@@ -326,35 +377,14 @@ public:
                                     VT& Av,
                                     bool pos = false) const
     {
-        NT lamda = 0;
-        NT min_plus  = std::numeric_limits<NT>::max();
-        NT max_minus = std::numeric_limits<NT>::lowest();
-        VT sum_nom;
-        int m = num_of_hyperplanes(), facet;
+        NT min_plus, max_minus;
+        int facet;
 
         Ar.noalias() = A * r.getCoefficients();
-        sum_nom = b - Ar;
-        Av.noalias() = A * v.getCoefficients();;
-
-
-        NT* Av_data = Av.data();
-        NT* sum_nom_data = sum_nom.data();
-
-        for (int i = 0; i < m; i++) {
-            if (*Av_data == NT(0)) {
-                //std::cout<<"div0"<<std::endl;
-                ;
-            } else {
-                lamda = *sum_nom_data / *Av_data;
-                if (lamda < min_plus && lamda > 0) {
-                    min_plus = lamda;
-                    if (pos) facet = i;
-                }else if (lamda > max_minus && lamda < 0) max_minus = lamda;
-            }
+        Av.noalias() = A * v.getCoefficients();
 
-            Av_data++;
-            sum_nom_data++;
-        }
+        FacetScan<NT>::apply(b.data(), Ar.data(), Av.data(), num_of_hyperplanes(),
+                             min_plus, max_minus, facet);
         if (pos) return std::make_pair(min_plus, facet);
         return std::make_pair(min_plus, max_minus);
     }
@@ -367,36 +397,14 @@ public:
                                     bool pos = false) const
     {
 
-        NT lamda = 0;
-        NT min_plus  = std::numeric_limits<NT>::max();
-        NT max_minus = std::numeric_limits<NT>::lowest();
-        VT  sum_nom;
-        NT mult;
-        //unsigned int i, j;
-        unsigned int j;
-        int m = num_of_hyperplanes(), facet;
+        NT min_plus, max_minus;
+        int facet;
 
         Ar.noalias() += lambda_prev*Av;
-        sum_nom = b - Ar;
         Av.noalias() = A * v.getCoefficients();
 
-        NT* sum_nom_data = sum_nom.data();
-        NT* Av_data = Av.data();
-
-        for (int i = 0; i < m; i++) {
-            if (*Av_data == NT(0)) {
-                //std::cout<<"div0"<<std::endl;
-                ;
-            } else {
-                lamda = *sum_nom_data / *Av_data;
-                if (lamda < min_plus && lamda > 0) {
-                    min_plus = lamda;
-                    if (pos) facet = i;
-                }else if (lamda > max_minus && lamda < 0) max_minus = lamda;
-            }
-            Av_data++;
-            sum_nom_data++;
-        }
+        FacetScan<NT>::apply(b.data(), Ar.data(), Av.data(), num_of_hyperplanes(),
+                             min_plus, max_minus, facet);
         if (pos) return std::make_pair(min_plus, facet);
         return std::make_pair(min_plus, max_minus);
     }
@@ -435,36 +443,15 @@ public:
                                                      VT& Av,
                                                      update_parameters& params) const
     {
-        NT min_plus  = std::numeric_limits<NT>::max();
-        NT max_minus = std::numeric_limits<NT>::lowest();
-
-        NT lamda = 0;
-        VT sum_nom;
-        int m = num_of_hyperplanes(), facet;
+        NT min_plus, max_minus;
+        int facet;
 
         Ar.noalias() = A * r.getCoefficients();
-        sum_nom.noalias() = b - Ar;
         Av.noalias() = A * v.getCoefficients();
 
-        NT* Av_data = Av.data();
-        NT* sum_nom_data = sum_nom.data();
-
-        for (int i = 0; i < m; i++) {
-            if (*Av_data == NT(0)) {
-                //std::cout<<"div0"<<std::endl;
-                ;
-            } else {
-                lamda = *sum_nom_data / *Av_data;
-                if (lamda < min_plus && lamda > 0) {
-                    min_plus = lamda;
-                    facet = i;
-                    params.inner_vi_ak = *Av_data;
-                }
-            }
-
-            Av_data++;
-            sum_nom_data++;
-        }
+        FacetScan<NT>::apply(b.data(), Ar.data(), Av.data(), num_of_hyperplanes(),
+                             min_plus, max_minus, facet);
+        if (facet >= 0) params.inner_vi_ak = Av(facet);
         params.facet_prev = facet;
         return std::pair<NT, int>(min_plus, facet);
     }
@@ -480,13 +467,9 @@ public:
                                                      update_parameters& params) const
     {
 
-        NT min_plus  = std::numeric_limits<NT>::max();
-        NT max_minus = std::numeric_limits<NT>::lowest();
-
-        NT lamda = 0;
+        NT min_plus, max_minus;
         NT inner_prev = params.inner_vi_ak;
-        VT sum_nom;
-        int m = num_of_hyperplanes(), facet;
+        int facet;
 
         Ar.noalias() += lambda_prev*Av;
         if(params.hit_ball) {
@@ -494,26 +477,10 @@ public:
         } else {
             Av.noalias() += (-2.0 * inner_prev) * AA.col(params.facet_prev);
         }
-        sum_nom.noalias() = b - Ar;
-
-        NT* sum_nom_data = sum_nom.data();
-        NT* Av_data = Av.data();
 
-        for (int i = 0; i < m; i++) {
-            if (*Av_data == NT(0)) {
-                //std::cout<<"div0"<<std::endl;
-                ;
-            } else {
-                lamda = *sum_nom_data / *Av_data;
-                if (lamda < min_plus && lamda > 0) {
-                    min_plus = lamda;
-                    facet = i;
-                    params.inner_vi_ak = *Av_data;
-                }
-            }
-            Av_data++;
-            sum_nom_data++;
-        }
+        FacetScan<NT>::apply(b.data(), Ar.data(), Av.data(), num_of_hyperplanes(),
+                             min_plus, max_minus, facet);
+        if (facet >= 0) params.inner_vi_ak = Av(facet);
         params.facet_prev = facet;
         return std::pair<NT, int>(min_plus, facet);
     }
@@ -527,36 +494,15 @@ public:
                                                NT const& lambda_prev,
                                                update_parameters& params) const
     {
-        NT min_plus  = std::numeric_limits<NT>::max();
-        NT max_minus = std::numeric_limits<NT>::lowest();
-
-        NT lamda = 0;
-        VT sum_nom;
-        unsigned int j;
-        int m = num_of_hyperplanes(), facet;
+        NT min_plus, max_minus;
+        int facet;
 
         Ar.noalias() += lambda_prev*Av;
-        sum_nom.noalias() = b - Ar;
         Av.noalias() = A * v.getCoefficients();
 
-        NT* sum_nom_data = sum_nom.data();
-        NT* Av_data = Av.data();
-
-        for (int i = 0; i < m; i++) {
-            if (*Av_data == NT(0)) {
-                //std::cout<<"div0"<<std::endl;
-                ;
-            } else {
-                lamda = *sum_nom_data / *Av_data;
-                if (lamda < min_plus && lamda > 0) {
-                    min_plus = lamda;
-                    facet = i;
-                    params.inner_vi_ak = *Av_data;
-                }
-            }
-            Av_data++;
-            sum_nom_data++;
-        }
+        FacetScan<NT>::apply(b.data(), Ar.data(), Av.data(), num_of_hyperplanes(),
+                             min_plus, max_minus, facet);
+        if (facet >= 0) params.inner_vi_ak = Av(facet);
         params.facet_prev = facet;
         return std::pair<NT, int>(min_plus, facet);
     }
@@ -570,34 +516,13 @@ public:
                                           unsigned int const& rand_coord,
                                           VT& lamdas) const
     {
+        NT min_plus, max_minus;
+        int facet;
 
-        NT lamda = 0;
-        NT min_plus  = std::numeric_limits<NT>::max();
-        NT max_minus = std::numeric_limits<NT>::lowest();
-        VT sum_denom;
-
-        int m = num_of_hyperplanes();
-
-        sum_denom = A.col(rand_coord);
         lamdas.noalias() = b - A * r.getCoefficients();
 
-        NT* lamda_data = lamdas.data();
-        NT* sum_denom_data = sum_denom.data();
-
-        for (int i = 0; i < m; i++) {
-
-            if (*sum_denom_data == NT(0)) {
-                //std::cout<<"div0"<<sum_denom<<std::endl;
-                ;
-            } else {
-                lamda = *lamda_data * (1 / *sum_denom_data);
-                if (lamda < min_plus && lamda > 0) min_plus = lamda;
-                if (lamda > max_minus && lamda < 0) max_minus = lamda;
-
-            }
-            lamda_data++;
-            sum_denom_data++;
-        }
+        FacetScan<NT>::apply(lamdas.data(), NULL, A.col(rand_coord).data(),
+                             num_of_hyperplanes(), min_plus, max_minus, facet);
         return std::make_pair(min_plus, max_minus);
     }
 
@@ -609,30 +534,14 @@ public:
                                           unsigned int const& rand_coord_prev,
                                           VT& lamdas) const
     {
-        NT lamda = 0;
-        NT min_plus  = std::numeric_limits<NT>::max();
-        NT max_minus = std::numeric_limits<NT>::lowest();
-
-        int m = num_of_hyperplanes();
+        NT min_plus, max_minus;
+        int facet;
 
         lamdas.noalias() += A.col(rand_coord_prev)
                          * (r_prev[rand_coord_prev] - r[rand_coord_prev]);
-        NT* data = lamdas.data();
-
-        for (int i = 0; i < m; i++) {
-            NT a = A(i, rand_coord);
 
-            if (a == NT(0)) {
-                //std::cout<<"div0"<<std::endl;
-                ;
-            } else {
-                lamda = *data / a;
-                if (lamda < min_plus && lamda > 0) min_plus = lamda;
-                if (lamda > max_minus && lamda < 0) max_minus = lamda;
-
-            }
-            data++;
-        }
+        FacetScan<NT>::apply(lamdas.data(), NULL, A.col(rand_coord).data(),
+                             num_of_hyperplanes(), min_plus, max_minus, facet);
         return std::make_pair(min_plus, max_minus);
     }
 
@@ -689,7 +598,17 @@ public:
 
     void compute_reflection(Point& v, Point const&, int const& facet) const
     {
-        v += -2 * v.dot(A.row(facet)) * A.row(facet);
+        v += (-2 * v.dot(A.row(facet))) * A.row(facet).transpose();
+    }
+
+    // reflect the direction of the j-th chain, stored in the j-th column of V,
+    // and update A*v in the j-th column of AV using AA = A*A^T
+    void compute_reflection(MT& V, MT& AV, MT const& AA,
+                            int const& j, int const& facet) const
+    {
+        NT inner_vi_ak = AV(facet, j);
+        V.col(j).noalias() += (-2.0 * inner_vi_ak) * A.row(facet).transpose();
+        AV.col(j).noalias() += (-2.0 * inner_vi_ak) * AA.col(facet);
     }
 
     NT log_barrier(Point &x, NT t = NT(100)) const {
@@ -722,8 +641,7 @@ public:
     template <typename update_parameters>
     void compute_reflection(Point &v, const Point &, update_parameters const& params) const {
 
-            Point a((-2.0 * params.inner_vi_ak) * A.row(params.facet_prev));
-            v += a;
+            v += (-2.0 * params.inner_vi_ak) * A.row(params.facet_prev).transpose();
     }
 
     template <class bfunc, class NonLinearOracle>
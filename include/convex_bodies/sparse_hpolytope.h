@@ -0,0 +1,492 @@
+// VolEsti (volume computation and sampling library)
+
+// Copyright (c) 2012-2020 Vissarion Fisikopoulos
+// Copyright (c) 2018-2020 Apostolos Chalkis
+
+// Licensed under GNU LGPL.3, see LICENCE file
+
+#ifndef SPARSE_HPOLYTOPE_H
+#define SPARSE_HPOLYTOPE_H
+
+#include <limits>
+#include <iostream>
+#include <vector>
+#include <Eigen/Eigen>
+#include <Eigen/Sparse>
+#include "convex_bodies/hpolytope.h"
+
+
+// H-polytope class with a sparse matrix A, e.g. the polytopes of metabolic
+// networks. The memory and the cost of the boundary oracles scale with the
+// number of nonzero entries of A instead of m*d.
+// The typedefs MT and VT are dense, as in HPolytope, so that the rounding
+// methods and the random walks can be used without changes.
+template <typename Point>
+class SparseHPolytope {
+public:
+    typedef Point                                             PointType;
+    typedef typename Point::FT                                NT;
+    typedef Eigen::Matrix<NT, Eigen::Dynamic, Eigen::Dynamic> MT;
+    typedef Eigen::Matrix<NT, Eigen::Dynamic, 1>              VT;
+    // the facets are stored row by row
+    typedef Eigen::SparseMatrix<NT, Eigen::RowMajor>          SpMT;
+    typedef Eigen::SparseMatrix<NT, Eigen::ColMajor>          SpMTcol;
+
+private:
+    unsigned int         _d; //dimension
+    SpMT                 A; //matrix A
+    SpMTcol              _A_cols; // a column major copy of A for coordinate directions
+    VT                   b; // vector b, s.t.: Ax<=b
+    std::pair<Point, NT> _inner_ball;
+
+public:
+    SparseHPolytope() {}
+
+    SparseHPolytope(unsigned d_, SpMT const& A_, VT const& b_) :
+        _d{d_}, A{A_}, _A_cols{A_}, b{b_}
+    {
+    }
+
+    SparseHPolytope(unsigned d_, MT const& A_, VT const& b_) :
+        _d{d_}, A{A_.sparseView()}, _A_cols{A}, b{b_}
+    {
+    }
+
+    //define matrix A and vector b, s.t. Ax<=b,
+    // from a matrix that contains both A and b, i.e., [A | b ]
+    SparseHPolytope(std::vector<std::vector<NT>> const& Pin)
+    {
+        std::vector<Eigen::Triplet<NT> > entries;
+
+        _d = Pin[0][1] - 1;
+        b.resize(Pin.size() - 1);
+        for (unsigned int i = 1; i < Pin.size(); i++) {
+            b(i - 1) = Pin[i][0];
+            for (unsigned int j = 1; j < _d + 1; j++) {
+                if (Pin[i][j] != NT(0)) {
+                    entries.push_back(Eigen::Triplet<NT>(i - 1, j - 1, -Pin[i][j]));
+                }
+            }
+        }
+        A.resize(Pin.size() - 1, _d);
+        A.setFromTriplets(entries.begin(), entries.end());
+        _A_cols = A;
+    }
+
+
+    std::pair<Point, NT> InnerBall() const
+    {
+        return _inner_ball;
+    }
+
+    void set_InnerBall(std::pair<Point,NT> const& innerball) //const
+    {
+        _inner_ball = innerball;
+    }
+
+    //Compute Chebyshev ball of H-polytope P:= Ax<=b
+    //Use LpSolve library
+    std::pair<Point, NT> ComputeInnerBall()
+    {
+        normalize();
+        #ifndef VOLESTIPY
+            _inner_ball = ComputeChebychevBall<NT, Point>(A, b); // use lpsolve library
+        #else
+
+            if (_inner_ball.second < 0.0) {
+
+                NT const tol = 0.00000001;
+                std::tuple<VT, NT, bool> inner_ball = max_inscribed_ball(MT(A), b, 150, tol);
+
+                // check if the solution is feasible
+                if (is_in(Point(std::get<0>(inner_ball))) == 0 || std::get<1>(inner_ball) < NT(0) ||
+                    std::isnan(std::get<1>(inner_ball)) || std::isinf(std::get<1>(inner_ball)) ||
+                    !std::get<2>(inner_ball) || is_inner_point_nan_inf(std::get<0>(inner_ball)))
+                {
+                    _inner_ball.second = -1.0;
+                } else
+                {
+                    _inner_ball.first = Point(std::get<0>(inner_ball));
+                    _inner_ball.second = std::get<1>(inner_ball);
+                }
+            }
+        #endif
+
+        return _inner_ball;
+    }
+
+    // return dimension
+    unsigned int dimension() const
+    {
+        return _d;
+    }
+
+
+    // return the number of facets
+    int num_of_hyperplanes() const
+    {
+        return A.rows();
+    }
+
+    int num_of_generators() const
+    {
+        return 0;
+    }
+
+
+    // return the matrix A
+    SpMT get_mat() const
+    {
+        return A;
+    }
+
+
+    // return the sparse matrix A*A^T
+    SpMT get_AA() const {
+        return SpMT(A * A.transpose());
+    }
+
+    // return the vector b
+    VT get_vec() const
+    {
+        return b;
+    }
+
+
+    // change the matrix A
+    void set_mat(SpMT const& A2)
+    {
+        A = A2;
+        _A_cols = A;
+    }
+
+    void set_mat(MT const& A2)
+    {
+        A = A2.sparseView();
+        _A_cols = A;
+    }
+
+
+    // change the vector b
+    void set_vec(VT const& b2)
+    {
+        b = b2;
+    }
+
+    Point get_mean_of_vertices() const
+    {
+        return Point(_d);
+    }
+
+    NT get_max_vert_norm() const
+    {
+        return 0.0;
+    }
+
+
+    // print polytope in input format
+    void print() {
+        std::cout << " " << A.rows() << " " << _d << " double" << std::endl;
+        for (unsigned int i = 0; i < A.rows(); i++) {
+            for (unsigned int j = 0; j < _d; j++) {
+                std::cout << A.coeff(i, j) << " ";
+            }
+            std::cout << "<= " << b(i) << std::endl;
+        }
+    }
+
+
+    //Check if Point p is in H-polytope P:= Ax<=b
+    int is_in(Point const& p, NT tol=NT(0)) const
+    {
+        int m = A.rows();
+
+        for (int i = 0; i < m; i++) {
+            //Check if corresponding hyperplane is violated
+            if (b(i) - row_dot(i, p) < NT(-tol))
+                return 0;
+        }
+        return -1;
+    }
+
+    // compute intersection point of ray starting from r and pointing to v
+    // with polytope discribed by A and b
+    std::pair<NT,NT> line_intersect(Point const& r, Point const& v) const
+    {
+        VT Ar, Av;
+        return line_intersect(r, v, Ar, Av);
+    }
+
+    // compute intersection point of a ray starting from r and pointing to v
+    // with polytope discribed by A and b
+    std::pair<NT,NT> line_intersect(Point const& r,
+                                    Point const& v,
+                                    VT& Ar,
+                                    VT& Av,
+                                    bool pos = false) const
+    {
+        NT min_plus, max_minus;
+        int facet;
+
+        Ar.noalias() = A * r.getCoefficients();
+        Av.noalias() = A * v.getCoefficients();
+
+        FacetScan<NT>::apply(b.data(), Ar.data(), Av.data(), num_of_hyperplanes(),
+                             min_plus, max_minus, facet);
+        if (pos) return std::make_pair(min_plus, facet);
+        return std::make_pair(min_plus, max_minus);
+    }
+
+    std::pair<NT,NT> line_intersect(Point const& r,
+                                    Point const& v,
+                                    VT& Ar,
+                                    VT& Av,
+                                    NT const& lambda_prev,
+                                    bool pos = false) const
+    {
+        NT min_plus, max_minus;
+        int facet;
+
+        Ar.noalias() += lambda_prev*Av;
+        Av.noalias() = A * v.getCoefficients();
+
+        FacetScan<NT>::apply(b.data(), Ar.data(), Av.data(), num_of_hyperplanes(),
+                             min_plus, max_minus, facet);
+        if (pos) return std::make_pair(min_plus, facet);
+        return std::make_pair(min_plus, max_minus);
+    }
+
+
+    // compute intersection point of a ray starting from r and pointing to v
+    // with polytope discribed by A and b
+    std::pair<NT, int> line_positive_intersect(Point const& r,
+                                               Point const& v,
+                                               VT& Ar,
+                                               VT& Av) const
+    {
+        return line_intersect(r, v, Ar, Av, true);
+    }
+
+
+    // compute intersection point of a ray starting from r and pointing to v
+    // with polytope discribed by A and b
+    std::pair<NT, int> line_positive_intersect(Point const& r,
+                                               Point const& v,
+                                               VT& Ar,
+                                               VT& Av,
+                                               NT const& lambda_prev) const
+    {
+        return line_intersect(r, v, Ar, Av, lambda_prev, true);
+    }
+
+
+    //---------------------------accelarated billiard----------------------------------
+    // compute intersection point of a ray starting from r and pointing to v
+    // with polytope discribed by A and b
+    template <typename update_parameters>
+    std::pair<NT, int> line_first_positive_intersect(Point const& r,
+                                                     Point const& v,
+                                                     VT& Ar,
+                                                     VT& Av,
+                                                     update_parameters& params) const
+    {
+        NT min_plus, max_minus;
+        int facet;
+
+        Ar.noalias() = A * r.getCoefficients();
+        Av.noalias() = A * v.getCoefficients();
+
+        FacetScan<NT>::apply(b.data(), Ar.data(), Av.data(), num_of_hyperplanes(),
+                             min_plus, max_minus, facet);
+        if (facet >= 0) params.inner_vi_ak = Av(facet);
+        params.facet_prev = facet;
+        return std::pair<NT, int>(min_plus, facet);
+    }
+
+
+    // A*v is updated after a reflection on the previous facet by the
+    // corresponding column of the sparse matrix AA = A*A^T
+    template <typename update_parameters>
+    std::pair<NT, int> line_positive_intersect(Point const& r,
+                                               Point const& v,
+                                               VT& Ar,
+                                               VT& Av,
+                                               NT const& lambda_prev,
+                                               SpMT const& AA,
+                                               update_parameters& params) const
+    {
+        NT min_plus, max_minus;
+        NT inner_prev = params.inner_vi_ak;
+        int facet;
+
+        Ar.noalias() += lambda_prev*Av;
+        if(params.hit_ball) {
+            Av.noalias() += (-2.0 * inner_prev) * (Ar / params.ball_inner_norm);
+        } else {
+            // AA is symmetric, thus its row is equal to its column
+            for (typename SpMT::InnerIterator it(AA, params.facet_prev); it; ++it) {
+                Av(it.col()) += (-2.0 * inner_prev) * it.value();
+            }
+        }
+
+        FacetScan<NT>::apply(b.data(), Ar.data(), Av.data(), num_of_hyperplanes(),
+                             min_plus, max_minus, facet);
+        if (facet >= 0) params.inner_vi_ak = Av(facet);
+        params.facet_prev = facet;
+        return std::pair<NT, int>(min_plus, facet);
+    }
+
+
+    template <typename update_parameters>
+    std::pair<NT, int> line_positive_intersect(Point const& r,
+                                               Point const& v,
+                                               VT& Ar,
+                                               VT& Av,
+                                               NT const& lambda_prev,
+                                               update_parameters& params) const
+    {
+        NT min_plus, max_minus;
+        int facet;
+
+        Ar.noalias() += lambda_prev*Av;
+        Av.noalias() = A * v.getCoefficients();
+
+        FacetScan<NT>::apply(b.data(), Ar.data(), Av.data(), num_of_hyperplanes(),
+                             min_plus, max_minus, facet);
+        if (facet >= 0) params.inner_vi_ak = Av(facet);
+        params.facet_prev = facet;
+        return std::pair<NT, int>(min_plus, facet);
+    }
+
+    //-----------------------------------------------------------------------------------//
+
+
+    //First coordinate ray intersecting convex polytope
+    //only the facets with a nonzero entry in column rand_coord are scanned
+    std::pair<NT,NT> line_intersect_coord(Point const& r,
+                                          unsigned int const& rand_coord,
+                                          VT& lamdas) const
+    {
+        lamdas.noalias() = b - A * r.getCoefficients();
+        return coord_scan(rand_coord, lamdas);
+    }
+
+
+    //Not the first coordinate ray intersecting convex
+    std::pair<NT,NT> line_intersect_coord(Point const& r,
+                                          Point const& r_prev,
+                                          unsigned int const& rand_coord,
+                                          unsigned int const& rand_coord_prev,
+                                          VT& lamdas) const
+    {
+        NT delta = r_prev[rand_coord_prev] - r[rand_coord_prev];
+        for (typename SpMTcol::InnerIterator it(_A_cols, rand_coord_prev); it; ++it) {
+            lamdas(it.row()) += it.value() * delta;
+        }
+        return coord_scan(rand_coord, lamdas);
+    }
+
+
+    // Apply linear transformation, of square matrix T^{-1}, in H-polytope P:= Ax<=b
+    // a dense T fills in A
+    void linear_transformIt(MT const& T)
+    {
+        A = (A * T).sparseView();
+        _A_cols = A;
+    }
+
+
+    // shift polytope by a point c
+
+    void shift(const VT &c)
+    {
+        b -= A*c;
+    }
+
+
+    // return for each facet the distance from the origin
+    std::vector<NT> get_dists(NT const& radius) const
+    {
+        unsigned int i=0;
+        std::vector <NT> dists(num_of_hyperplanes(), NT(0));
+        typename std::vector<NT>::iterator disit = dists.begin();
+        for ( ; disit!=dists.end(); disit++, i++)
+            *disit = b(i) / A.row(i).norm();
+
+        return dists;
+    }
+
+    // no points given for the rounding, you have to sample from the polytope
+    template <typename T>
+    bool get_points_for_rounding (T const& /*randPoints*/)
+    {
+        return false;
+    }
+
+    SpMT get_T() const
+    {
+        return A;
+    }
+
+    void normalize()
+    {
+        NT row_norm;
+        for (int i = 0; i < num_of_hyperplanes(); ++i)
+        {
+            row_norm = A.row(i).norm();
+            for (typename SpMT::InnerIterator it(A, i); it; ++it) {
+                it.valueRef() /= row_norm;
+            }
+            b(i) = b(i) / row_norm;
+        }
+        _A_cols = A;
+    }
+
+    void compute_reflection(Point& v, Point const&, int const& facet) const
+    {
+        reflect(v, facet, -2 * row_dot(facet, v));
+    }
+
+    template <typename update_parameters>
+    void compute_reflection(Point &v, const Point &, update_parameters const& params) const {
+
+        reflect(v, params.facet_prev, -2.0 * params.inner_vi_ak);
+    }
+
+private:
+
+    // the inner product of the i-th row of A with p
+    NT row_dot(int const& i, Point const& p) const
+    {
+        NT sum = NT(0);
+        for (typename SpMT::InnerIterator it(A, i); it; ++it) {
+            sum += it.value() * p[it.col()];
+        }
+        return sum;
+    }
+
+    // v += c * A_i, where A_i is the i-th row of A
+    void reflect(Point& v, int const& i, NT const& c) const
+    {
+        for (typename SpMT::InnerIterator it(A, i); it; ++it) {
+            v.set_coord(it.col(), v[it.col()] + c * it.value());
+        }
+    }
+
+    // scan the ratios lamdas_i / A(i, coord) of the facets with A(i, coord) != 0
+    std::pair<NT,NT> coord_scan(unsigned int const& coord, VT const& lamdas) const
+    {
+        NT lamda;
+        NT min_plus  = std::numeric_limits<NT>::max();
+        NT max_minus = std::numeric_limits<NT>::lowest();
+
+        for (typename SpMTcol::InnerIterator it(_A_cols, coord); it; ++it) {
+            lamda = lamdas(it.row()) / it.value();
+            if (lamda < min_plus && lamda > 0) min_plus = lamda;
+            if (lamda > max_minus && lamda < 0) max_minus = lamda;
+        }
+        return std::make_pair(min_plus, max_minus);
+    }
+};
+
+#endif
@@ -16,8 +16,13 @@
 #include <iterator>
 #include <vector>
 #include "sampling/sphere.hpp"
+#include "lp_oracles/solve_lp.h"
+#include "misc/parallel_tasks.hpp"
 
 
+// The intersection of k V-polytopes. Each oracle is the combination of the
+// oracles of the V-polytopes; with n_threads > 1 they are evaluated concurrently,
+// each V-polytope keeps its own LPs thus the threads do not share any LP.
 template <typename VPolytope, typename RNGType>
 class IntersectionOfVpoly {
 public:
@@ -29,21 +34,39 @@ public:
     unsigned seed;
     std::pair<Point,NT> _inner_ball;
     NT rad;
-    VPolytope P1;
-    VPolytope P2;
+    std::vector<VPolytope> polys;
+    unsigned int n_threads;
 
-    IntersectionOfVpoly(): P1(), P2() {}
+    IntersectionOfVpoly(): n_threads(1) {}
 
-    IntersectionOfVpoly(VPolytope P, VPolytope Q) : P1(P), P2(Q) {
+    IntersectionOfVpoly(VPolytope P, VPolytope Q) : polys{P, Q}, n_threads(1) {
         seed = std::chrono::system_clock::now().time_since_epoch().count();
     }
 
-    IntersectionOfVpoly(VPolytope P, VPolytope Q, unsigned _seed) : P1(P), P2(Q)  {
+    IntersectionOfVpoly(VPolytope P, VPolytope Q, unsigned _seed) : polys{P, Q}, n_threads(1) {
         seed = _seed;
     }
 
-    VPolytope first() { return P1; }
-    VPolytope second() { return P2; }
+    IntersectionOfVpoly(std::vector<VPolytope> const& Ps) : polys(Ps), n_threads(1) {
+        seed = std::chrono::system_clock::now().time_since_epoch().count();
+    }
+
+    IntersectionOfVpoly(std::vector<VPolytope> const& Ps, unsigned _seed) : polys(Ps), n_threads(1) {
+        seed = _seed;
+    }
+
+    VPolytope first() { return polys[0]; }
+    VPolytope second() { return polys[1]; }
+
+    // the number of V-polytopes
+    unsigned int num_of_polytopes() const {
+        return polys.size();
+    }
+
+    // evaluate the oracles of the V-polytopes on n_threads threads
+    void set_num_threads(unsigned int const& num_threads) {
+        n_threads = num_threads;
+    }
 
     std::pair<Point,NT> InnerBall() const
     {
@@ -51,9 +74,20 @@ public:
     }
 
     int is_in(const Point &p) const {
-        if(P1.is_in(p)==-1)
-            return P2.is_in(p);
-        return 0;
+        if (n_threads == 1) {
+            for (auto const& P : polys) {
+                if (P.is_in(p) == 0) return 0;
+            }
+            return -1;
+        }
+        std::vector<int> res(polys.size());
+        run_parallel_for(polys.size(), n_threads, [&](unsigned int i) {
+            res[i] = polys[i].is_in(p);
+        });
+        for (int r : res) {
+            if (r == 0) return 0;
+        }
+        return -1;
     }
 
 
@@ -62,11 +96,13 @@ public:
     }
 
     unsigned int dimension() const {
-        return P1.dimension();
+        return polys[0].dimension();
     }
 
     int num_of_vertices() const {
-        return P1.num_of_vertices() + P2.num_of_vertices();
+        int num = 0;
+        for (auto const& P : polys) num += P.num_of_vertices();
+        return num;
     }
 
     unsigned int upper_bound_of_hyperplanes() const {
@@ -83,23 +119,23 @@ public:
     }
 
     MT get_mat() const {
-        return P1.get_mat();
+        return polys[0].get_mat();
     }
 
     VT get_vec() const {
-        return P1.get_vec();
+        return polys[0].get_vec();
     }
 
     MT get_T() const {
-        return P1.get_mat();
+        return polys[0].get_mat();
     }
 
     MT get_mat2() const {
-        return P2.get_mat();
+        return polys[1].get_mat();
     }
 
     Point get_mean_of_vertices() const {
-        return Point(P1.dimension());
+        return Point(dimension());
     }
 
 
@@ -108,26 +144,29 @@ public:
     }
 
     void print() {
-        P1.print();
-        P2.print();
+        for (auto& P : polys) P.print();
+    }
+
+    std::vector<MT> get_mats() const {
+        std::vector<MT> Vs;
+        for (auto const& P : polys) Vs.push_back(P.get_mat());
+        return Vs;
     }
 
     bool is_feasible() {
         bool empty;
-        int k = P1.get_mat().rows() + P2.get_mat().rows();
+        int k = num_of_vertices();
         RNGType rng(k);
         rng.set_seed(seed);
-        PointInIntersection<VT>(P1.get_mat(), P2.get_mat(),
-                                GetDirection<Point>::apply(k, rng), empty);
+        PointInIntersection<VT>(get_mats(), GetDirection<Point>::apply(k, rng), empty);
         return !empty;
     }
 
     std::pair<Point,NT> ComputeInnerBall() {
 
-        unsigned int num = 0, d = P1.dimension();
-        MT V1 = P1.get_mat(), V2 = P2.get_mat();
-        int k1 = V1.rows(), k2 = V2.rows();
-        int k = k1 + k2;
+        unsigned int num = 0, d = dimension();
+        std::vector<MT> Vs = get_mats();
+        int k = num_of_vertices();
         RNGType rng(k);
         rng.set_seed(seed);
         Point direction(k), p(d);
@@ -138,7 +177,7 @@ public:
         while(num<d+1){
 
             direction = GetDirection<Point>::apply(k, rng);
-            p = PointInIntersection<VT>(V1, V2, direction, same);
+            p = PointInIntersection<VT>(Vs, direction, same);
 
             same = false;
             rvert = vertices.begin();
@@ -154,7 +193,7 @@ public:
 
         }
 
-        _inner_ball = P1.get_center_radius_inscribed_simplex(vertices.begin(), vertices.end());
+        _inner_ball = polys[0].get_center_radius_inscribed_simplex(vertices.begin(), vertices.end());
         return _inner_ball;
 
     }
@@ -219,11 +258,11 @@ public:
     // with the V-polytope
     std::pair<NT,NT> line_intersect(const Point &r, const Point &v) const {
 
-        std::pair <NT, NT> P1pair = P1.line_intersect(r, v);
-        std::pair <NT, NT> P2pair = P2.line_intersect(r, v);
-        return std::pair<NT, NT>(std::min(P1pair.first, P2pair.first),
-                                 std::max(P1pair.second, P2pair.second));
-
+        std::vector<std::pair<NT, NT>> pairs(polys.size());
+        run_parallel_for(polys.size(), n_threads, [&](unsigned int i) {
+            pairs[i] = polys[i].line_intersect(r, v);
+        });
+        return intersect_pairs(pairs);
     }
 
     // compute intersection point of ray starting from r and pointing to v
@@ -241,15 +280,20 @@ public:
         return line_intersect(r, v);
     }
 
+    // the second element of the result is the index, starting from 1, of the
+    // V-polytope whose boundary is hit first
     std::pair<NT, int> line_positive_intersect(const Point &r, const Point &v) const {
 
-        std::pair<NT, int> P1pair = P1.line_positive_intersect(r, v);
-        std::pair<NT, int> P2pair = P2.line_positive_intersect(r, v);
+        std::vector<NT> lambdas(polys.size());
+        run_parallel_for(polys.size(), n_threads, [&](unsigned int i) {
+            lambdas[i] = polys[i].line_positive_intersect(r, v).first;
+        });
 
-        if(P1pair.first < P2pair.first) {
-            return std::pair<NT, int>(P1pair.first, 1);
+        int first = 0;
+        for (int i = 1; i < int(polys.size()); ++i) {
+            if (lambdas[i] <= lambdas[first]) first = i;
         }
-        return std::pair<NT, int>(P2pair.first, 2);
+        return std::pair<NT, int>(lambdas[first], first + 1);
     }
 
     std::pair<NT, int> line_positive_intersect(const Point &r, const Point &v, const VT &Ar,
@@ -304,10 +348,11 @@ public:
     std::pair<NT,NT> line_intersect_coord(const Point &r,
                                           const unsigned int &rand_coord,
                                           const VT &lamdas) const {
-        std::pair <NT, NT> P1pair = P1.line_intersect_coord(r, rand_coord, lamdas);
-        std::pair <NT, NT> P2pair = P2.line_intersect_coord(r, rand_coord, lamdas);
-        return std::pair<NT, NT>(std::min(P1pair.first, P2pair.first),
-                                 std::max(P1pair.second, P2pair.second));
+        std::vector<std::pair<NT, NT>> pairs(polys.size());
+        run_parallel_for(polys.size(), n_threads, [&](unsigned int i) {
+            pairs[i] = polys[i].line_intersect_coord(r, rand_coord, lamdas);
+        });
+        return intersect_pairs(pairs);
     }
 
 
@@ -324,15 +369,13 @@ public:
 
     // shift polytope by a point c
     void shift(const VT &c) {
-        P1.shift(c);
-        P2.shift(c);
+        for (auto& P : polys) P.shift(c);
     }
 
 
     // apply linear transformation, of square matrix T, to the V-Polytope
     void linear_transformIt(const MT &T) {
-        P1.linear_transformIt(T);
-        P2.linear_transformIt(T);
+        for (auto& P : polys) P.linear_transformIt(T);
     }
 
     std::vector<NT> get_dists(const NT &radius) const {
@@ -345,11 +388,10 @@ public:
         if (num_of_vertices()>40*dimension()) {
             return false;
         }
-        if(!P1.get_points_for_rounding(randPoints)) {
-            return false;
-        }
-        if(!P2.get_points_for_rounding(randPoints)) {
-            return false;
+        for (auto& P : polys) {
+            if (!P.get_points_for_rounding(randPoints)) {
+                return false;
+            }
         }
 
         return true;
@@ -358,24 +400,24 @@ public:
     void normalize() {}
 
     void compute_reflection (Point &v, const Point &p, const int &facet) const {
-
-        if (facet == 1) {
-            P1.compute_reflection (v, p, facet);
-        } else {
-            P1.compute_reflection (v, p, facet);
-        }
-
+        polys[facet - 1].compute_reflection (v, p, facet);
     }
 
     template <typename update_parameters>
     void compute_reflection (Point &v, const Point &p, update_parameters const& params) const {
+        polys[params.facet_prev - 1].compute_reflection (v, p, params);
+    }
 
-        if (params.facet_prev == 1) {
-            P1.compute_reflection (v, p, params);
-        } else {
-            P2.compute_reflection (v, p, params);
+private:
+    // the intersection of the chords of the V-polytopes: the first elements are
+    // the positive parameters and the second elements the negative ones
+    static std::pair<NT, NT> intersect_pairs(std::vector<std::pair<NT, NT>> const& pairs) {
+        std::pair<NT, NT> res = pairs[0];
+        for (unsigned int i = 1; i < pairs.size(); ++i) {
+            res.first = std::min(res.first, pairs[i].first);
+            res.second = std::max(res.second, pairs[i].second);
         }
-
+        return res;
     }
 
 };
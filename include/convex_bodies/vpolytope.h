@@ -12,11 +12,14 @@
 #ifndef VPOLYTOPE_H
 #define VPOLYTOPE_H
 
+#include <algorithm>
 #include <limits>
 #include <iostream>
+#include <numeric>
 #include <Eigen/Eigen>
 
 #include "lp_oracles/vpolyoracles.h"
+#include "misc/parallel_tasks.hpp"
 #include <khach.h>
 
 
@@ -39,8 +42,19 @@ private:
     REAL *conv_comb, *conv_comb2, *conv_mem, *row;
     int *colno, *colno_mem;
 
+    // the ray-shooting and the membership LPs, they persist between the oracle
+    // calls of a chain and they are not shared by the copies of the polytope
+    mutable PersistentLP ray_lp, mem_lp;
+
+    // the directions that separated the previous infeasible points of is_in
+    mutable SupportDirectionCache<NT> support_cache;
+
 public:
-    VPolytope() {}
+    VPolytope() :
+            conv_comb{nullptr}, conv_comb2{nullptr}, conv_mem{nullptr}, row{nullptr},
+            colno{nullptr}, colno_mem{nullptr}
+    {
+    }
 
     VPolytope(const unsigned int &dim, const MT &_V, const VT &_b):
             _d{dim}, V{_V}, b{_b},
@@ -76,11 +90,11 @@ public:
     }
 
     template <typename T>
-    void copy_array(T* source, T* result, size_t count)
+    void copy_array(T* source, T*& result, size_t count)
     {
         T* tarray;
         tarray = new T[count];
-        std::copy_n(source, count, tarray);
+        if (source != nullptr) std::copy_n(source, count, tarray);
         delete [] result;
         result = tarray;
     }
@@ -91,6 +105,10 @@ public:
             _d = other._d;
             V = other.V;
             b = other.b;
+            _inner_ball = other._inner_ball;
+            ray_lp.reset();
+            mem_lp.reset();
+            support_cache.reset();
 
             copy_array(other.conv_comb, conv_comb, V.rows() + 1);
             copy_array(other.conv_comb2, conv_comb2, V.rows() + 1);
@@ -108,13 +126,17 @@ public:
             _d = other._d;
             V = other.V;
             b = other.b;
-
-            conv_comb = other.conv_comb;  other.conv_comb = nullptr;
-            conv_comb2 = other.conv_comb2;  other.conv_comb2 = nullptr;
-            conv_mem = other.conv_mem;  other.conv_mem = nullptr;
-            row = other.row; other.row = nullptr;
-            colno = other.colno; colno = nullptr;
-            colno_mem = other.colno_mem; colno_mem = nullptr;
+            _inner_ball = other._inner_ball;
+            ray_lp.reset();
+            mem_lp.reset();
+            support_cache.reset();
+
+            std::swap(conv_comb, other.conv_comb);
+            std::swap(conv_comb2, other.conv_comb2);
+            std::swap(conv_mem, other.conv_mem);
+            std::swap(row, other.row);
+            std::swap(colno, other.colno);
+            std::swap(colno_mem, other.colno_mem);
         }
         return *this;
     }
@@ -129,6 +151,7 @@ public:
             colno{new int[V.rows() + 1]},
             colno_mem{new int[V.rows()]}
     {
+        _inner_ball = other._inner_ball;
         std::copy_n(other.conv_comb, V.rows() + 1, conv_comb);
         std::copy_n(other.conv_comb2, V.rows() + 1, conv_comb2);
         std::copy_n(other.conv_mem, V.rows(), conv_mem);
@@ -142,12 +165,13 @@ public:
             conv_comb{nullptr}, conv_comb2{nullptr}, conv_mem{nullptr}, row{nullptr},
             colno{nullptr}, colno_mem{nullptr}
     {
+        _inner_ball = other._inner_ball;
         conv_comb = other.conv_comb;  other.conv_comb = nullptr;
         conv_comb2 = other.conv_comb2;  other.conv_comb2 = nullptr;
         conv_mem = other.conv_mem;  other.conv_mem = nullptr;
         row = other.row; other.row = nullptr;
-        colno = other.colno; colno = nullptr;
-        colno_mem = other.colno_mem; colno_mem = nullptr;
+        colno = other.colno; other.colno = nullptr;
+        colno_mem = other.colno_mem; other.colno_mem = nullptr;
     }
 
     ~VPolytope() {
@@ -169,6 +193,105 @@ public:
         _inner_ball = innerball;
     }
 
+    // remove the rows of V that are not vertices of the polytope, i.e. the
+    // duplicates and the points that belong to the convex hull of the other
+    // points. The points that are the furthest from the centroid or the unique
+    // extremes of a coordinate are vertices; each other point is tested with a
+    // membership LP over the rest of the points, on n_threads threads.
+    // Return the number of removed points.
+    int remove_redundant_points(unsigned int n_threads = 1)
+    {
+        int m = V.rows();
+        std::vector<char> redundant(m, 0), vertex(m, 0);
+
+        // remove the duplicates, the first copy of each point is kept
+        std::vector<int> order(m);
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&](int i, int j) {
+            for (unsigned int k = 0; k < _d; ++k) {
+                if (V(i, k) != V(j, k)) return V(i, k) < V(j, k);
+            }
+            return i < j;
+        });
+        for (int k = 1; k < m; ++k) {
+            if (V.row(order[k]) == V.row(order[k - 1])) redundant[order[k]] = 1;
+        }
+
+        std::vector<int> points;
+        for (int i = 0; i < m; ++i) {
+            if (!redundant[i]) points.push_back(i);
+        }
+        int n = points.size();
+        if (n == 0) return 0;
+
+        VT c = VT::Zero(_d), dists(m);
+        for (int i : points) c += V.row(i).transpose();
+        c /= NT(n);
+        NT max_dist = 0.0;
+        for (int i : points) {
+            dists(i) = (V.row(i).transpose() - c).squaredNorm();
+            max_dist = std::max(max_dist, dists(i));
+        }
+        for (int i : points) {
+            if (dists(i) == max_dist) vertex[i] = 1;
+        }
+        for (unsigned int k = 0; k < _d; ++k) {
+            int imax = points[0], imin = points[0], nmax = 0, nmin = 0;
+            for (int i : points) {
+                if (V(i, k) > V(imax, k)) {
+                    imax = i;
+                    nmax = 1;
+                } else if (V(i, k) == V(imax, k)) {
+                    nmax++;
+                }
+                if (V(i, k) < V(imin, k)) {
+                    imin = i;
+                    nmin = 1;
+                } else if (V(i, k) == V(imin, k)) {
+                    nmin++;
+                }
+            }
+            if (nmax == 1) vertex[imax] = 1;
+            if (nmin == 1) vertex[imin] = 1;
+        }
+
+        std::vector<int> candidates;
+        for (int i : points) {
+            if (!vertex[i]) candidates.push_back(i);
+        }
+        run_parallel_for(candidates.size(), n_threads, [&](unsigned int t)
+        {
+            int i = candidates[t], count = 0;
+            MT V2(n - 1, _d);
+            for (int j : points) {
+                if (j != i) V2.row(count++) = V.row(j);
+            }
+            std::vector<REAL> lp_row(_d + 1);
+            std::vector<int> lp_colno(_d + 1);
+            if (memLP_Vpoly(V2, Point(V.row(i)), lp_row.data(), lp_colno.data())) {
+                redundant[i] = 1;
+            }
+        });
+
+        int removed = std::count(redundant.begin(), redundant.end(), 1);
+        if (removed == 0) return 0;
+
+        MT V2(m - removed, _d);
+        VT b2(m - removed);
+        for (int i = 0, count = 0; i < m; ++i) {
+            if (redundant[i]) continue;
+            V2.row(count) = V.row(i);
+            if (b.size() == m) b2(count) = b(i);
+            count++;
+        }
+        V = V2;
+        if (b.size() == m) b = b2;
+        ray_lp.reset();
+        mem_lp.reset();
+        support_cache.reset();
+        return removed;
+    }
+
     // return dimension
     unsigned int dimension() const {
         return _d;
@@ -209,6 +332,9 @@ public:
     // change the matrix V
     void set_mat(const MT &V2) {
         V = V2;
+        ray_lp.reset();
+        mem_lp.reset();
+        support_cache.reset();
     }
 
     // change the vector b
@@ -376,7 +502,7 @@ public:
         for (unsigned int i = 0; i < _d; ++i) {
             v.set_to_origin();
             v.set_coord(i, 1.0);
-            res = intersect_double_line_Vpoly<NT>(V, center, v, row, colno);
+            res = intersect_double_line_Vpoly<NT>(ray_lp, V, center, v);
             min_plus = std::min(res.first, -1.0*res.second);
             if (min_plus < radius) radius = min_plus;
         }
@@ -389,9 +515,17 @@ public:
 
     // check if point p belongs to the convex hull of V-Polytope P
     int is_in(const Point &p, NT tol=NT(0)) const {
-        if (memLP_Vpoly(V, p, conv_mem, colno_mem)){
+        if (support_cache.separates(p)) {
+            return 0;
+        }
+        if (memLP_Vpoly(mem_lp, V, p)){
             return -1;
         }
+        if (!mem_lp.empty() && get_status(mem_lp.lp) == OPTIMAL) {
+            // the first _d coordinates of the solution separate p from P
+            get_variables(mem_lp.lp, mem_lp.row.data());
+            support_cache.insert(V, mem_lp.row.data());
+        }
         return 0;
     }
 
@@ -400,7 +534,7 @@ public:
     // with the V-polytope
     std::pair<NT,NT> line_intersect(const Point &r, const Point &v) const {
 
-        return intersect_double_line_Vpoly<NT>(V, r, v, row, colno);
+        return intersect_double_line_Vpoly<NT>(ray_lp, V, r, v);
     }
 
 
@@ -408,7 +542,7 @@ public:
     // with the V-polytope
     std::pair<NT,NT> line_intersect(const Point &r, const Point &v, const VT &Ar,
             const VT &Av) const {
-        return intersect_double_line_Vpoly<NT>(V, r, v,  row, colno);
+        return intersect_double_line_Vpoly<NT>(ray_lp, V, r, v);
     }
 
     // compute intersection point of ray starting from r and pointing to v
@@ -416,12 +550,12 @@ public:
     std::pair<NT,NT> line_intersect(const Point &r, const Point &v, const VT &Ar,
                                     const VT &Av, const NT &lambda_prev) const {
 
-        return intersect_double_line_Vpoly<NT>(V, r, v,  row, colno);
+        return intersect_double_line_Vpoly<NT>(ray_lp, V, r, v);
     }
 
 
     std::pair<NT, int> line_positive_intersect(const Point &r, const Point &v) const {
-        return std::pair<NT, int> (intersect_line_Vpoly(V, r, v, conv_comb, row, colno, false, false), 1);
+        return std::pair<NT, int> (intersect_line_Vpoly(ray_lp, V, r, v, conv_comb, false, false), 1);
     }
 
     std::pair<NT, int> line_positive_intersect(const Point &r, const Point &v, const VT &Ar,
@@ -478,7 +612,7 @@ public:
                                           const VT &lamdas) const {
         Point v(_d);
         v.set_coord(rand_coord, 1.0);
-        return intersect_double_line_Vpoly<NT>(V, r, v,  row, colno);
+        return intersect_double_line_Vpoly<NT>(ray_lp, V, r, v);
     }
 
 
@@ -497,6 +631,9 @@ public:
     void shift(const VT &c) {
         MT V2 = V.transpose().colwise() - c;
         V = V2.transpose();
+        ray_lp.reset();
+        mem_lp.reset();
+        support_cache.reset();
     }
 
 
@@ -504,6 +641,9 @@ public:
     void linear_transformIt(const MT &T) {
         MT V2 = T.inverse() * V.transpose();
         V = V2.transpose();
+        ray_lp.reset();
+        mem_lp.reset();
+        support_cache.reset();
     }
 
 
@@ -18,6 +18,7 @@
 #include <Eigen/Eigen>
 #include "lp_oracles/vpolyoracles.h"
 #include "lp_oracles/zpolyoracles.h"
+#include "lp_oracles/zpoly_active_set.h"
 
 template <typename Point>
 class Zonotope {
@@ -41,10 +42,23 @@ private:
     MT                   sigma;
     MT                   Q0;
 
+    // the ray-shooting and the membership LPs, they persist between the oracle
+    // calls of a chain and they are not shared by the copies of the zonotope
+    mutable PersistentLP ray_lp, mem_lp;
+
+    // the LP-free ray-shooting oracle and the normal of the facet of its last
+    // positive intersection, empty when it has been computed by the LP
+    mutable ZonotopeActiveSet<NT> active_set;
+    mutable VT facet_normal;
+
 
 public:
 
-    Zonotope() {}
+    Zonotope() :
+            conv_comb{nullptr}, row_mem{nullptr}, row{nullptr},
+            colno{nullptr}, colno_mem{nullptr}
+    {
+    }
 
     Zonotope(const unsigned int &dim, const MT &_V, const VT &_b):
             _d{dim}, V{_V}, b{_b},
@@ -102,11 +116,11 @@ public:
     }
 
     template <typename T>
-    void copy_array(T* source, T* result, size_t count)
+    void copy_array(T* source, T*& result, size_t count)
     {
         T* tarray;
         tarray = new T[count];
-        std::copy_n(source, count, tarray);
+        if (source != nullptr) std::copy_n(source, count, tarray);
         delete [] result;
         result = tarray;
     }
@@ -118,6 +132,10 @@ public:
             V = other.V;
             b = other.b;
             T = other.T;
+            _inner_ball = other._inner_ball;
+            ray_lp.reset();
+            mem_lp.reset();
+            active_set.reset();
 
             copy_array(other.conv_comb, conv_comb, V.rows() + 1);
             copy_array(other.row_mem, row_mem, V.rows());
@@ -135,12 +153,16 @@ public:
             V = other.V;
             b = other.b;
             T = other.T;
-
-            conv_comb = other.conv_comb;  other.conv_comb = nullptr;
-            row_mem = other.row_mem;  other.row_mem = nullptr;
-            row = other.row; other.row = nullptr;
-            colno = other.colno; colno = nullptr;
-            colno_mem = other.colno_mem; colno_mem = nullptr;
+            _inner_ball = other._inner_ball;
+            ray_lp.reset();
+            mem_lp.reset();
+            active_set.reset();
+
+            std::swap(conv_comb, other.conv_comb);
+            std::swap(row_mem, other.row_mem);
+            std::swap(row, other.row);
+            std::swap(colno, other.colno);
+            std::swap(colno_mem, other.colno_mem);
         }
         return *this;
     }
@@ -154,6 +176,7 @@ public:
             colno{new int[V.rows() + 1]},
             colno_mem{new int[V.rows()]}
     {
+        _inner_ball = other._inner_ball;
         std::copy_n(other.conv_comb, V.rows() + 1, conv_comb);
         std::copy_n(other.row_mem, V.rows(), row_mem);
         std::copy_n(other.row, V.rows() + 1, row);
@@ -166,11 +189,12 @@ public:
             conv_comb{nullptr}, row_mem{nullptr}, row{nullptr},
             colno{nullptr}, colno_mem{nullptr}
     {
+        _inner_ball = other._inner_ball;
         conv_comb = other.conv_comb;  other.conv_comb = nullptr;
         row_mem = other.row_mem;  other.row_mem = nullptr;
         row = other.row; other.row = nullptr;
-        colno = other.colno; colno = nullptr;
-        colno_mem = other.colno_mem; colno_mem = nullptr;
+        colno = other.colno; other.colno = nullptr;
+        colno_mem = other.colno_mem; other.colno_mem = nullptr;
     }
 
     ~Zonotope() {
@@ -296,6 +320,9 @@ public:
     void set_mat(MT const& V2)
     {
         V = V2;
+        ray_lp.reset();
+        mem_lp.reset();
+        active_set.reset();
     }
 
     // change the vector b
@@ -338,7 +365,7 @@ public:
     // check if point p belongs to the convex hull of V-Polytope P
     int is_in(Point const& p) const
     {
-        if(memLP_Zonotope(V, p, row_mem, colno_mem))
+        if(memLP_Zonotope(mem_lp, V, p))
         {
             return -1;
         }
@@ -357,8 +384,8 @@ public:
             temp.assign(_d,0);
             temp[i] = 1.0;
             Point v(_d,temp.begin(), temp.end());
-            min_plus = intersect_line_Vpoly<NT>(V, center, v, conv_comb,
-                                                row, colno, false, true);
+            min_plus = intersect_line_Vpoly<NT>(ray_lp, V, center, v, conv_comb,
+                                                false, true);
             if (min_plus < radius) radius = min_plus;
         }
 
@@ -371,7 +398,13 @@ public:
     // with the Zonotope
     std::pair<NT,NT> line_intersect(Point const& r, Point const& v) const
     {
-        return intersect_line_zono(V, r, v, conv_comb, colno);
+        std::pair<NT,NT> res;
+        if (active_set.solve(V, r.getCoefficients(), v.getCoefficients(), true, res.first)
+            && active_set.solve(V, r.getCoefficients(), v.getCoefficients(), false, res.second))
+        {
+            return res;
+        }
+        return intersect_line_zono<NT>(ray_lp, V, r, v);
     }
 
 
@@ -382,7 +415,7 @@ public:
                                     VT const& Ar,
                                     VT const& Av) const
     {
-        return intersect_line_zono(V, r, v, conv_comb, colno);
+        return line_intersect(r, v);
     }
 
     // compute intersection point of ray starting from r and pointing to v
@@ -393,7 +426,7 @@ public:
                                     VT const& Av,
                                     NT const& lambda_prev) const
     {
-        return intersect_line_zono(V, r, v, conv_comb, colno);
+        return line_intersect(r, v);
     }
 
     std::pair<NT, int> line_positive_intersect(Point const& r,
@@ -401,8 +434,14 @@ public:
                                                VT const& Ar,
                                                VT const& Av) const
     {
-        return std::pair<NT, int> (intersect_line_Vpoly(V, r, v, conv_comb,
-                                                        row, colno,
+        NT lambda;
+        if (active_set.solve(V, r.getCoefficients(), v.getCoefficients(), true, lambda))
+        {
+            active_set.get_normal(true, facet_normal);
+            return std::pair<NT, int> (lambda, 1);
+        }
+        facet_normal.resize(0);
+        return std::pair<NT, int> (intersect_line_Vpoly(ray_lp, V, r, v, conv_comb,
                                                         false, true), 1);
     }
 
@@ -462,7 +501,7 @@ public:
         temp[rand_coord]=1.0;
         Point v(_d,temp.begin(), temp.end());
 
-        return intersect_line_zono(V, r, v, conv_comb, colno);
+        return line_intersect(r, v);
 
     }
 
@@ -501,6 +540,9 @@ public:
     {
         MT V2 = T.inverse() * V.transpose();
         V = V2.transpose();
+        ray_lp.reset();
+        mem_lp.reset();
+        active_set.reset();
     }
 
     // return false to the rounding function
@@ -513,10 +555,10 @@ public:
 
     void normalize() {}
 
-    void compute_reflection(Point &v, Point const& p, int const& facet) const
+    // the normal of the facet of the last positive intersection computed by the LP,
+    // the generators with coefficients in (-1,1) span the facet
+    VT conv_comb_normal(Point const& p) const
     {
-        //compute_reflection(v, p, 0.0);
-
         int count = 0;
         MT Fmat(_d-1,_d);
         const NT e = 0.0000000001;
@@ -536,7 +578,12 @@ public:
 
         if(p.getCoefficients().dot(a) < 0.0) a *= -1.0;
 
-        a = a/a.norm();
+        return a/a.norm();
+    }
+
+    void compute_reflection(Point &v, Point const& p, int const& facet) const
+    {
+        VT a = (facet_normal.size() == _d) ? facet_normal : conv_comb_normal(p);
 
         // compute reflection
         a *= (-2.0 * v.dot(a));
@@ -546,26 +593,7 @@ public:
     template <typename update_parameters>
     void compute_reflection(Point &v, const Point &p, update_parameters const& params) const {
 
-        int count = 0;
-        MT Fmat(_d-1,_d);
-        const NT e = 0.0000000001;
-        for (int j = 0; j < num_of_generators(); ++j) {
-            if (((1.0 - *(conv_comb + j) ) > e || (1.0 - *(conv_comb + j) ) > e*std::abs(*(conv_comb + j))) &&
-                ((1.0 + *(conv_comb + j) ) > e || (1.0 + *(conv_comb + j) ) > e*std::abs(*(conv_comb + j)))) {
-                Fmat.row(count) = V.row(j);
-                count++;
-            }
-        }
-
-        VT a = Fmat.fullPivLu().kernel();
-
-        if(p.getCoefficients().dot(a) < 0.0) a *= -1.0;
-
-        a = a/a.norm();
-
-        // compute reflection
-        a *= (-2.0 * v.dot(a));
-        v += a;
+        compute_reflection(v, p, 0);
     }
 
 };
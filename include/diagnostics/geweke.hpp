@@ -38,6 +38,8 @@ bool perform_geweke(MT const& samples,
                     NT frac_last = 0.5,
                     NT alpha = 0.05)
 {
+    typedef typename MT::PlainObject PlainMT;
+
     unsigned int d = samples.rows(), N = samples.cols();
     unsigned int N1 = N * frac_first;
     unsigned int N2 = N * frac_last;
@@ -46,14 +48,14 @@ bool perform_geweke(MT const& samples,
     VT mean1 = samples.block(0, 0, d, N1).rowwise().mean();
     VT mean2 = samples.block(0, N - N2, d, N2).rowwise().mean();
 
-    MT norm_chain1 = samples.block(0, 0, d, N1).colwise() - mean1;
-    MT norm_chain2 = samples.block(0, N - N2, d, N2).colwise() - mean2;
+    PlainMT norm_chain1 = samples.block(0, 0, d, N1).colwise() - mean1;
+    PlainMT norm_chain2 = samples.block(0, N - N2, d, N2).colwise() - mean2;
 
-    MT sigma1 = (norm_chain1 * norm_chain1.transpose()) / (NT(N1) - 1.0);
-    MT sigma2 = (norm_chain2 * norm_chain2.transpose()) / (NT(N2) - 1.0);
+    PlainMT sigma1 = (norm_chain1 * norm_chain1.transpose()) / (NT(N1) - 1.0);
+    PlainMT sigma2 = (norm_chain2 * norm_chain2.transpose()) / (NT(N2) - 1.0);
 
     // Compute the pooled covariance matrix
-    MT S_pl = ((NT(N1) - NT(1)) * sigma1 + (NT(N2) - 1.0) * sigma2) / (NT(N1) + NT(N2) - NT(2));
+    PlainMT S_pl = ((NT(N1) - NT(1)) * sigma1 + (NT(N2) - 1.0) * sigma2) / (NT(N1) + NT(N2) - NT(2));
 
     // T2 follows Hotelling's T-squared distribution under the assumption of
     // equal covariances and when the null hypothesis is true
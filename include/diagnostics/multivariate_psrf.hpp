@@ -25,6 +25,8 @@
 template <typename NT, typename VT, typename MT>
 NT multivariate_psrf(MT const& samples)
 {
+    typedef typename MT::PlainObject PlainMT;
+
     unsigned int N = samples.cols(), d = samples.rows();
     unsigned int N1 = N / 2;
     unsigned int N2 = N - N1;
@@ -32,19 +34,19 @@ NT multivariate_psrf(MT const& samples)
     VT mean1 = samples.block(0, 0, d, N1).rowwise().mean();
     VT mean2 = samples.block(0, N1, d, N - N1).rowwise().mean();
 
-    MT norm_chain1 = samples.block(0, 0, d, N1).colwise() - mean1;
-    MT norm_chain2 = samples.block(0, N1, d, N - N1).colwise() - mean2;
+    PlainMT norm_chain1 = samples.block(0, 0, d, N1).colwise() - mean1;
+    PlainMT norm_chain2 = samples.block(0, N1, d, N - N1).colwise() - mean2;
 
-    MT W = ((norm_chain1 * norm_chain1.transpose()) / (NT(N1) - 1.0) +
-            (norm_chain2 * norm_chain2.transpose()) / (NT(N2) - 1.0)) / NT(2);
+    PlainMT W = ((norm_chain1 * norm_chain1.transpose()) / (NT(N1) - 1.0) +
+                 (norm_chain2 * norm_chain2.transpose()) / (NT(N2) - 1.0)) / NT(2);
 
     VT mean00 = (mean1 + mean2) / 2.0;
 
-    MT B = (mean1 - mean00) * (mean1 - mean00).transpose() +
-           (mean2 - mean00) * (mean2 - mean00).transpose();
+    PlainMT B = (mean1 - mean00) * (mean1 - mean00).transpose() +
+                (mean2 - mean00) * (mean2 - mean00).transpose();
 
-    MT WB = W.inverse() * B;
-    Eigen::SelfAdjointEigenSolver <MT> eigensolver(WB);
+    PlainMT WB = W.inverse() * B;
+    Eigen::SelfAdjointEigenSolver <PlainMT> eigensolver(WB);
     NT l_max = eigensolver.eigenvalues().maxCoeff();
 
     NT R = (NT(N1) - NT(1))/NT(N1) + 1.5 * l_max;
@@ -44,15 +44,17 @@ NT fix(NT x)
 
 
 template <typename VT, typename MT, typename NT>
-MT perform_raftery(MT const& samples, NT const& q, NT const& r, NT const& s)
+typename MT::PlainObject perform_raftery(MT const& samples, NT const& q, NT const& r, NT const& s)
 {
-    MT runs = samples.transpose();
+    typedef typename MT::PlainObject PlainMT;
+
+    PlainMT runs = samples.transpose();
 
     typedef Eigen::Matrix<int,Eigen::Dynamic,Eigen::Dynamic> MTint;
     typedef Eigen::Matrix<int,Eigen::Dynamic,1> VTint;
 
     unsigned int n = runs.rows(), d = runs.cols(), kthin, kmind;
-    MT results(d, 6);
+    PlainMT results(d, 6);
     MTint work = MTint::Zero(n, d);
     VTint tmp = VTint::Zero(n);
     std::pair<int, VTint> xy;
@@ -61,7 +63,7 @@ MT perform_raftery(MT const& samples, NT const& q, NT const& r, NT const& s)
     NT cutpt, alpha, beta, g2, bic, epss;
     int tcnt;
 
-    MT sorted_samples(n, d);
+    PlainMT sorted_samples(n, d);
     VT a(n);
     std::vector<NT> temp_col(n);
 
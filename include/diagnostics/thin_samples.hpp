@@ -12,7 +12,8 @@
 #define DIAGNOSTICS_THIN_SAMPLES_HPP
 
 template <typename NT, typename VT, typename MT>
-MT thin_samples(MT const& samples, NT const& min_ess) {
+typename MT::PlainObject thin_samples(MT const& samples, NT const& min_ess) {
+    typedef typename MT::PlainObject PlainMT;
 
     // Sample matrix is provided as d x n_samples
     unsigned int d = samples.rows();
@@ -24,7 +25,7 @@ MT thin_samples(MT const& samples, NT const& min_ess) {
     gap = N / min_ess;
     N_gap = N - N % gap;
 
-    MT thin_samples;
+    PlainMT thin_samples;
     thin_samples.resize(d, N_gap / gap);
 
     for (int i = 0; i < N_gap; i += gap) {
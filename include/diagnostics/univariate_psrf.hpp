@@ -25,7 +25,9 @@
 template <typename NT, typename VT, typename MT>
 VT univariate_psrf(MT const& samples)
 {
-    MT runs = samples.transpose();
+    typedef typename MT::PlainObject PlainMT;
+
+    PlainMT runs = samples.transpose();
     unsigned int N = samples.cols(), d = samples.rows();
     unsigned int N1 = N / 2;
     unsigned int N2 = N - N1;
@@ -8,8 +8,54 @@
 #define GENERATORS_BOOST_RANDOM_NUMBER_GENERATOR_HPP
 
 #include <chrono>
+#include <cstdint>
 #include <boost/random.hpp>
 
+#include "generators/philox_engine.hpp"
+
+/////////////////// Seeds for independent streams
+///
+/// Derive the seed of the stream_id-th stream (e.g. one per thread or chain)
+/// from a single user seed. The pair is mixed with the splitmix64 finalizer
+/// so that consecutive stream ids give uncorrelated seeds.
+
+inline unsigned int get_stream_seed(unsigned int const& seed,
+                                    unsigned int const& stream_id)
+{
+    std::uint64_t z = (std::uint64_t(seed) << 32) + std::uint64_t(stream_id)
+                      + 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    z = z ^ (z >> 31);
+    return static_cast<unsigned int>(z >> 32);
+}
+
+/////////////////// Streams of the engines
+///
+/// Switch rng to the stream stream_id of seed: engines with a state seeded by
+/// a single integer get the seed get_stream_seed(seed, stream_id), the
+/// counter-based engine is keyed by the pair.
+
+template <typename RNGType>
+struct EngineStreams
+{
+    static void set_stream(RNGType& rng, unsigned int const& seed,
+                           unsigned int const& stream_id)
+    {
+        rng.seed(get_stream_seed(seed, stream_id));
+    }
+};
+
+template <>
+struct EngineStreams<philox4x32>
+{
+    static void set_stream(philox4x32& rng, unsigned int const& seed,
+                           unsigned int const& stream_id)
+    {
+        rng.seed(seed, stream_id);
+    }
+};
+
 /////////////////// Random numbers generator
 ///
 /// \tparam RNGType
@@ -48,6 +94,24 @@ struct BoostRandomNumberGenerator<RNGType, NT>
         _rng.seed(rng_seed);
     }
 
+    // switch to the stream_id-th independent stream of seed
+    void set_stream(unsigned int const& seed, unsigned int const& stream_id)
+    {
+        EngineStreams<RNGType>::set_stream(_rng, seed, stream_id);
+    }
+
+    // fill out[0, n) with uniform numbers in [0, 1)
+    void sample_urdist(NT* out, unsigned int const& n)
+    {
+        for (unsigned int i = 0; i < n; ++i) out[i] = _urdist(_rng);
+    }
+
+    // fill out[0, n) with standard normal numbers
+    void sample_ndist(NT* out, unsigned int const& n)
+    {
+        for (unsigned int i = 0; i < n; ++i) out[i] = _ndist(_rng);
+    }
+
 private :
     RNGType _rng;
     boost::random::uniform_real_distribution<NT> _urdist;
@@ -85,6 +149,24 @@ struct BoostRandomNumberGenerator<RNGType, NT, Seed>
         _rng.seed(rng_seed);
     }
 
+    // switch to the stream_id-th independent stream of seed
+    void set_stream(unsigned int const& seed, unsigned int const& stream_id)
+    {
+        EngineStreams<RNGType>::set_stream(_rng, seed, stream_id);
+    }
+
+    // fill out[0, n) with uniform numbers in [0, 1)
+    void sample_urdist(NT* out, unsigned int const& n)
+    {
+        for (unsigned int i = 0; i < n; ++i) out[i] = _urdist(_rng);
+    }
+
+    // fill out[0, n) with standard normal numbers
+    void sample_ndist(NT* out, unsigned int const& n)
+    {
+        for (unsigned int i = 0; i < n; ++i) out[i] = _ndist(_rng);
+    }
+
 private :
     RNGType _rng;
     boost::random::uniform_real_distribution<NT> _urdist;
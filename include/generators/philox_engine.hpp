@@ -0,0 +1,135 @@
+// VolEsti (volume computation and sampling library)
+
+// Copyright (c) 2020 Vissarion Fisikopoulos
+
+// Licensed under GNU LGPL.3, see LICENCE file
+
+#ifndef GENERATORS_PHILOX_ENGINE_HPP
+#define GENERATORS_PHILOX_ENGINE_HPP
+
+#include <cstdint>
+#include <limits>
+
+/////////////////// Counter-based random number engine
+///
+/// The Philox4x32-10 generator of Salmon et al. (Random123, SC'11). The n-th
+/// block of four 32-bit outputs is a bijection of the counter n keyed by
+/// (seed, stream), thus any stream is independent of the others, a stream
+/// is selected in O(1) by its key and discard(n) costs O(1). It models the
+/// engine concept of Boost.Random, e.g.
+/// BoostRandomNumberGenerator<philox4x32, double>.
+
+class philox4x32
+{
+public:
+    typedef std::uint32_t result_type;
+
+    static constexpr result_type min()
+    {
+        return 0;
+    }
+
+    static constexpr result_type max()
+    {
+        return std::numeric_limits<result_type>::max();
+    }
+
+    explicit philox4x32(std::uint64_t const& seed_value = 0)
+    {
+        seed(seed_value);
+    }
+
+    philox4x32(std::uint32_t const& seed_value, std::uint32_t const& stream)
+    {
+        seed(seed_value, stream);
+    }
+
+    // the stream (seed, 0) for a 32-bit seed
+    void seed(std::uint64_t const& seed_value)
+    {
+        seed(std::uint32_t(seed_value), std::uint32_t(seed_value >> 32));
+    }
+
+    void seed(std::uint32_t const& seed_value, std::uint32_t const& stream)
+    {
+        _key[0] = seed_value;
+        _key[1] = stream;
+        _counter = 0;
+        _index = 4;
+    }
+
+    result_type operator()()
+    {
+        if (_index == 4)
+        {
+            generate_block(_counter++, _block);
+            _index = 0;
+        }
+        return _block[_index++];
+    }
+
+    void discard(unsigned long long n)
+    {
+        n += _index;
+        _counter += n / 4 - 1;
+        _index = 4;
+        if (n % 4 != 0)
+        {
+            generate_block(_counter++, _block);
+            _index = n % 4;
+        }
+    }
+
+    friend bool operator==(philox4x32 const& a, philox4x32 const& b)
+    {
+        return a._key[0] == b._key[0] && a._key[1] == b._key[1]
+               && a._counter == b._counter && a._index == b._index;
+    }
+
+    friend bool operator!=(philox4x32 const& a, philox4x32 const& b)
+    {
+        return !(a == b);
+    }
+
+    // the block of the 128-bit counter (c0, c1, c2, c3) under the key (k0, k1)
+    static void philox_block(std::uint32_t const* counter,
+                             std::uint32_t const* key,
+                             std::uint32_t* out)
+    {
+        std::uint32_t c0 = counter[0], c1 = counter[1], c2 = counter[2], c3 = counter[3];
+        std::uint32_t k0 = key[0], k1 = key[1];
+
+        for (int round = 0; round < 10; ++round)
+        {
+            std::uint64_t p0 = std::uint64_t(0xD2511F53) * c0;
+            std::uint64_t p1 = std::uint64_t(0xCD9E8D57) * c2;
+            std::uint32_t n0 = std::uint32_t(p1 >> 32) ^ c1 ^ k0;
+            std::uint32_t n2 = std::uint32_t(p0 >> 32) ^ c3 ^ k1;
+            c1 = std::uint32_t(p1);
+            c3 = std::uint32_t(p0);
+            c0 = n0;
+            c2 = n2;
+            k0 += 0x9E3779B9;
+            k1 += 0xBB67AE85;
+        }
+        out[0] = c0;
+        out[1] = c1;
+        out[2] = c2;
+        out[3] = c3;
+    }
+
+private:
+
+    void generate_block(std::uint64_t const& n, std::uint32_t* out) const
+    {
+        std::uint32_t counter[4] = {std::uint32_t(n), std::uint32_t(n >> 32), 0, 0};
+        philox_block(counter, _key, out);
+    }
+
+    std::uint32_t _key[2];
+    std::uint64_t _counter;  // the next block
+    std::uint32_t _block[4];
+    unsigned int _index;     // the next output of _block
+};
+
+#endif // GENERATORS_PHILOX_ENGINE_HPP
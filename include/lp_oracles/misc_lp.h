@@ -20,7 +20,7 @@ std::pair<Point,NT> ComputeChebychevBall(MT &A, VT &b){
     int *colno = NULL;
 
     REAL *row = NULL;
-    std::pair<Point,NT> exception_pair(Point(1),-1.0);
+    std::pair<Point,NT> exception_pair(Point(d),-1.0);
 
     try
     {
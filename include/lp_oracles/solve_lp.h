@@ -27,11 +27,49 @@
 #include <stdio.h>
 #include <cmath>
 #include <exception>
+#include <vector>
 #undef Realloc
 #undef Free
 #include "lp_lib.h"
 
 
+// write the i-th row of A, followed by its norm, in the arrays of lpsolve
+// and return the number of the entries
+template <typename MT>
+int chebychev_row(MT const& A, int const& i, int* colno, REAL* row)
+{
+    int d = A.cols();
+    typename MT::Scalar sum = 0;
+    for (int j = 0; j < d; j++) {
+        colno[j] = j + 1;
+        row[j] = A(i, j);
+        sum += A(i, j) * A(i, j);
+    }
+    colno[d] = d + 1; /* last column */
+    row[d] = std::sqrt(sum);
+    return d + 1;
+}
+
+// only the nonzero entries of a sparse row are given to lpsolve
+template <typename NT, typename Index>
+int chebychev_row(Eigen::SparseMatrix<NT, Eigen::RowMajor, Index> const& A,
+                  int const& i, int* colno, REAL* row)
+{
+    typedef typename Eigen::SparseMatrix<NT, Eigen::RowMajor, Index>::InnerIterator
+            InnerIterator;
+    int count = 0;
+    NT sum = NT(0);
+    for (InnerIterator it(A, i); it; ++it) {
+        colno[count] = it.col() + 1;
+        row[count] = it.value();
+        sum += it.value() * it.value();
+        count++;
+    }
+    colno[count] = A.cols() + 1; /* last column */
+    row[count] = std::sqrt(sum);
+    return count + 1;
+}
+
 // compute the chebychev ball of an H-polytope described by a dxd matrix A and  d-dimensional vector b, s.t.: Ax<=b
 template <typename NT, typename Point, typename MT, typename VT>
 std::pair<Point,NT> ComputeChebychevBall(const MT &A, const VT &b){
@@ -42,7 +80,7 @@ std::pair<Point,NT> ComputeChebychevBall(const MT &A, const VT &b){
     int *colno = NULL;
 
     REAL *row = NULL;
-    std::pair<Point,NT> exception_pair(Point(1),-1.0);
+    std::pair<Point,NT> exception_pair(Point(d),-1.0);
 
     try
     {
@@ -74,21 +112,13 @@ std::pair<Point,NT> ComputeChebychevBall(const MT &A, const VT &b){
 
     set_add_rowmode(lp, TRUE);  /* makes building the model faster if it is done rows by row */
 
-    NT sum;
     for (i = 0; i < m; ++i) {
         /* construct all rows */
-        sum=NT(0);
-        for(j=0; j<d; j++){
-            colno[j] = j+1;
-            row[j] = A(i,j);
-            sum+=A(i,j)*A(i,j);
-        }
-        colno[d] = d+1; /* last column */
-        row[d] = std::sqrt(sum);
+        int count = chebychev_row(A, i, colno, row);
 
         /* add the row to lpsolve */
         try {
-            if(!add_constraintex(lp, d+1, row, colno, LE, b(i))) throw false;
+            if(!add_constraintex(lp, count, row, colno, LE, b(i))) throw false;
         }
         catch (bool e)
         {
@@ -157,23 +187,29 @@ std::pair<Point,NT> ComputeChebychevBall(const MT &A, const VT &b){
 }
 
 
+// compute a point in the intersection of the V-polytopes with vertices the rows
+// of the matrices in Vs. The variables are the coefficients of the convex
+// combinations of the vertices of each V-polytope, and the objective is given
+// by direction, a vector of dimension the total number of vertices.
+// empty is true when the intersection is empty
 template <typename VT, typename MT, typename Point>
-Point PointInIntersection(MT V1, MT V2, Point direction, bool &empty) {
+Point PointInIntersection(std::vector<MT> const& Vs, Point direction, bool &empty) {
 
     typedef typename Point::FT NT;
-    unsigned int d = V1.cols();
-    unsigned int k1 = V1.rows();
-    unsigned int k2 = V2.rows();
-    unsigned int k = k1 + k2;
+    unsigned int d = Vs[0].cols();
+    unsigned int k1 = Vs[0].rows();
+    unsigned int num_polys = Vs.size(), k = 0;
+    for (unsigned int l = 0; l < num_polys; ++l) k += Vs[l].rows();
     VT cb(k1);
     lprec *lp;
     int Ncol=k, *colno = NULL, j, i;
     REAL *row = NULL;
     Point p(d);
+    unsigned int Nrows = (num_polys - 1) * d + num_polys;
 
     try
     {
-        lp = make_lp(d+2, Ncol);
+        lp = make_lp(Nrows, Ncol);
         if(lp == NULL) throw false;
     }
     catch (bool e) {
@@ -200,37 +236,54 @@ Point PointInIntersection(MT V1, MT V2, Point direction, bool &empty) {
 
     set_add_rowmode(lp, TRUE);  /* makes building the model faster if it is done rows by row */
 
+    for(j=0; j<Ncol; j++){
+        colno[j] = j+1;
+    }
 
-    for (i = 0;  i< d+2; ++i) {
-        /* construct all rows */
-        for(j=0; j<k1; j++){
-            colno[j] = j+1;
-            if (i==d) {
-                row[j] = 1.0;
-            } else if(i==d+1){
-                row[j] = 0.0;
-            } else {
-                row[j] = V1(j, i);
+    // the point of the first V-polytope equals the point of each other V-polytope
+    for (unsigned int l = 1; l < num_polys; ++l) {
+        for (i = 0; i < d; ++i) {
+            int offset = 0;
+            for (unsigned int t = 0; t < num_polys; ++t) {
+                for (j = 0; j < Vs[t].rows(); ++j) {
+                    if (t == 0) {
+                        row[offset + j] = Vs[0](j, i);
+                    } else if (t == l) {
+                        row[offset + j] = -Vs[l](j, i);
+                    } else {
+                        row[offset + j] = 0.0;
+                    }
+                }
+                offset += Vs[t].rows();
+            }
+
+            /* add the row to lpsolve */
+            try {
+                if (!add_constraintex(lp, Ncol, row, colno, EQ, 0.0)) throw false;
+            }
+            catch (bool e)
+            {
+#ifdef VOLESTI_DEBUG
+                std::cout<<"Could not construct constaints for the Linear Program for membership "<<e<<std::endl;
+#endif
+                return false;
             }
         }
-        for(j=0; j<k2; j++){
-            colno[k1+j] = k1+j+1;
-            if (i==d) {
-                row[k1+j] = 0.0;
-            } else if(i==d+1){
-                row[k1+j] = 1.0;
-            } else {
-                row[k1+j] = -V2(j, i);
+    }
+
+    // the coefficients of each V-polytope sum to one
+    for (unsigned int l = 0; l < num_polys; ++l) {
+        int offset = 0;
+        for (unsigned int t = 0; t < num_polys; ++t) {
+            for (j = 0; j < Vs[t].rows(); ++j) {
+                row[offset + j] = (t == l) ? 1.0 : 0.0;
             }
+            offset += Vs[t].rows();
         }
 
         /* add the row to lpsolve */
         try {
-            if(i==d || i==d+1) {
-                if (!add_constraintex(lp, Ncol, row, colno, EQ, 1.0)) throw false;
-            } else {
-                if (!add_constraintex(lp, Ncol, row, colno, EQ, 0.0)) throw false;
-            }
+            if (!add_constraintex(lp, Ncol, row, colno, EQ, 1.0)) throw false;
         }
         catch (bool e)
         {
@@ -276,6 +329,8 @@ Point PointInIntersection(MT V1, MT V2, Point direction, bool &empty) {
     /* Now let lpsolve calculate a solution */
     if (solve(lp) != OPTIMAL){
         delete_lp(lp);
+        free(row);
+        free(colno);
         empty = true;
         return p;
     }
@@ -285,12 +340,24 @@ Point PointInIntersection(MT V1, MT V2, Point direction, bool &empty) {
     for ( j=0; j<k1; ++j) {
         cb(j) = row[j];
     }
+    free(row);
+    free(colno);
 
-    p = V1.transpose()*cb;
+    p = Vs[0].transpose()*cb;
     empty = false;
     return p;
 
 }
 
 
+template <typename VT, typename MT, typename Point>
+Point PointInIntersection(MT V1, MT V2, Point direction, bool &empty) {
+
+    std::vector<MT> Vs;
+    Vs.push_back(V1);
+    Vs.push_back(V2);
+    return PointInIntersection<VT>(Vs, direction, empty);
+}
+
+
 #endif
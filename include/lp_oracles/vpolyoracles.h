@@ -24,11 +24,137 @@
 #include <stdio.h>
 #include <cmath>
 #include <exception>
+#include <vector>
+#include <Eigen/Eigen>
 #undef Realloc
 #undef Free
 #include "lp_lib.h"
 
 
+// An lpsolve model that persists between the calls of an oracle, e.g. the
+// steps of a random walk. The model is built at the first call and the next
+// calls only update the entries that depend on the query; a warm solve starts
+// from the optimal basis of the previous solve in the same direction.
+// A copy does not share the model, it builds its own at its first call, so
+// that each chain (thread) that owns a copy of the polytope has its own model.
+class PersistentLP
+{
+public:
+    PersistentLP() : lp(NULL) {}
+
+    PersistentLP(PersistentLP const&) : lp(NULL) {}
+
+    PersistentLP& operator=(PersistentLP const&)
+    {
+        reset();
+        return *this;
+    }
+
+    ~PersistentLP()
+    {
+        reset();
+    }
+
+    // drop the model, e.g. when the polytope changes
+    void reset()
+    {
+        if (lp != NULL) delete_lp(lp);
+        lp = NULL;
+        basis_max.clear();
+        basis_min.clear();
+    }
+
+    bool empty() const
+    {
+        return lp == NULL;
+    }
+
+    // maximize (maxi = true) or minimize the objective and return the status of lpsolve,
+    // a cold solve (warm = false) starts from the slack basis
+    int solve(bool maxi, bool warm = true)
+    {
+        std::vector<int>& basis = maxi ? basis_max : basis_min;
+
+        if (maxi) {
+            set_maxim(lp);
+        } else {
+            set_minim(lp);
+        }
+        if (!warm || basis.empty() || !set_basis(lp, basis.data(), TRUE)) default_basis(lp);
+
+        int status = ::solve(lp);
+        if (status == OPTIMAL) {
+            basis.resize(1 + get_Nrows(lp) + get_Ncolumns(lp));
+            get_basis(lp, basis.data(), TRUE);
+        } else {
+            basis.clear();
+        }
+        return status;
+    }
+
+    lprec* lp;
+    std::vector<REAL> row;
+    std::vector<int> colno;
+
+private:
+    std::vector<int> basis_max, basis_min;
+};
+
+
+// A few directions u with the values h(u) = max_i V_i u of the support function
+// of the V-polytope with vertices the rows of V. A point q with u q > h(u) is not
+// in the polytope. The membership oracle stores the separating directions that its
+// LP returns, thus the next points of a walk that leave the polytope through the
+// same part of the boundary are rejected without solving an LP.
+template <typename NT>
+class SupportDirectionCache
+{
+    typedef Eigen::Matrix<NT, Eigen::Dynamic, Eigen::Dynamic> MT;
+    typedef Eigen::Matrix<NT, Eigen::Dynamic, 1>              VT;
+
+public:
+    SupportDirectionCache() : size(0), next(0) {}
+
+    void reset()
+    {
+        size = 0;
+        next = 0;
+    }
+
+    // return true if a cached direction separates q from the polytope
+    template <typename Point>
+    bool separates(Point const& q) const
+    {
+        for (unsigned int k = 0; k < size; ++k) {
+            if (U.row(k).dot(q.getCoefficients()) > h(k)) return true;
+        }
+        return false;
+    }
+
+    // store the direction given by the first V.cols() entries of u, the oldest
+    // direction is replaced when the cache is full
+    void insert(MT const& V, REAL const* u)
+    {
+        unsigned int d = V.cols();
+        if (U.rows() == 0) {
+            U.resize(2 * d, d);
+            h.resize(2 * d);
+        }
+        for (unsigned int j = 0; j < d; ++j) U(next, j) = u[j];
+        Vu.noalias() = V * U.row(next).transpose();
+        h(next) = Vu.maxCoeff();
+
+        next = (next + 1) % U.rows();
+        if (size < U.rows()) size++;
+    }
+
+private:
+    MT U;
+    VT h, Vu;
+    unsigned int size, next;
+};
+
+
 // return true if q belongs to the convex hull of the V-polytope described by matrix V
 // otherwise return false
 template <typename MT, typename Point, typename NT>
@@ -423,5 +549,159 @@ std::pair<NT,NT> intersect_double_line_Vpoly(const MT &V, const Point &p, const
     return res_pair;
 }
 
+// Build the model of intersect_line_Vpoly in a persistent LP,
+// the direction and the starting point of the ray are set at each call
+template <typename MT>
+bool build_ray_shooting_lp(PersistentLP& plp, MT const& V, bool zonotope)
+{
+    int d = V.cols(), k = V.rows(), j;
+
+    plp.lp = make_lp(0, k + 1);
+    if (plp.lp == NULL) return false;
+    plp.row.resize(k + 1);
+    plp.colno.resize(k + 1);
+    REAL *row = plp.row.data();
+    int *colno = plp.colno.data();
+    REAL infinite = get_infinite(plp.lp);
+
+    set_add_rowmode(plp.lp, TRUE);
+    for (int i = 0; i < d; i++) {
+        for (j = 0; j < k; j++) {
+            colno[j] = j + 1;
+            row[j] = V(j, i);
+        }
+        colno[k] = k + 1; /* the column of the ray */
+        row[k] = 0.0;
+        if (!add_constraintex(plp.lp, k + 1, row, colno, EQ, 0.0)) {
+            plp.reset();
+            return false;
+        }
+    }
+    if (!zonotope) {
+        for (j = 0; j < k; j++) row[j] = 1.0;
+        row[k] = 0.0;
+        if (!add_constraintex(plp.lp, k + 1, row, colno, EQ, 1.0)) {
+            plp.reset();
+            return false;
+        }
+    }
+    set_add_rowmode(plp.lp, FALSE);
+
+    for (j = 0; j < k; j++) {
+        if (!zonotope) {
+            set_bounds(plp.lp, j + 1, 0.0, 1.0);
+        } else {
+            set_bounds(plp.lp, j + 1, -1.0, 1.0);
+        }
+        row[j] = 0.0;
+    }
+    row[k] = 1.0;
+    set_bounds(plp.lp, k + 1, -infinite, infinite);
+    set_obj_fnex(plp.lp, k + 1, row, colno);
+    set_verbose(plp.lp, NEUTRAL);
+    return true;
+}
+
+
+// set the ray p + t v in a persistent ray-shooting LP
+template <typename Point>
+void set_ray_shooting_lp(PersistentLP& plp, Point const& p, Point const& v)
+{
+    int d = v.dimension();
+    REAL *column = plp.row.data();
+    int *rowno = plp.colno.data();
+
+    rowno[0] = 0; /* the objective function */
+    column[0] = 1.0;
+    for (int i = 0; i < d; i++) {
+        rowno[i + 1] = i + 1;
+        column[i + 1] = v[i];
+        set_rh(plp.lp, i + 1, p[i]);
+    }
+    set_columnex(plp.lp, get_Ncolumns(plp.lp), d + 1, column, rowno);
+}
+
+
+// as intersect_line_Vpoly, the LP is updated in place and warm-started
+template <typename NT, typename MT, typename Point>
+NT intersect_line_Vpoly(PersistentLP& plp, const MT &V, const Point &p, const Point &v,
+                        NT *conv_comb, bool maxi, bool zonotope)
+{
+    if (plp.empty() && !build_ray_shooting_lp(plp, V, zonotope)) return -1.0;
+
+    set_ray_shooting_lp(plp, p, v);
+    if (plp.solve(maxi) != OPTIMAL) return -1.0;
+
+    get_variables(plp.lp, conv_comb);
+    return NT(-get_objective(plp.lp));
+}
+
+
+// as intersect_double_line_Vpoly, the LP is updated in place and warm-started
+template <typename NT, typename MT, typename Point>
+std::pair<NT,NT> intersect_double_line_Vpoly(PersistentLP& plp, const MT &V,
+                                             const Point &p, const Point &v)
+{
+    std::pair<NT,NT> res_pair;
+    if (plp.empty() && !build_ray_shooting_lp(plp, V, false)) return res_pair;
+
+    set_ray_shooting_lp(plp, p, v);
+    plp.solve(true);
+    res_pair.second = NT(-get_objective(plp.lp));
+    plp.solve(false);
+    res_pair.first = NT(-get_objective(plp.lp));
+    return res_pair;
+}
+
+
+// as memLP_Vpoly, the LP is updated in place; it is solved cold since the
+// interior points are degenerate optima with value zero and a warm basis can
+// return a small positive value for them
+template <typename MT, typename Point>
+bool memLP_Vpoly(PersistentLP& plp, const MT &V, const Point &q)
+{
+    int d = q.dimension(), m = V.rows(), j;
+
+    if (plp.empty()) {
+        plp.lp = make_lp(0, d + 1);
+        if (plp.lp == NULL) return false;
+        plp.row.resize(d + 1);
+        plp.colno.resize(d + 1);
+
+        REAL infinite = get_infinite(plp.lp);
+        set_add_rowmode(plp.lp, TRUE);
+        for (int i = 0; i < m; ++i) {
+            for (j = 0; j < d; j++) {
+                plp.colno[j] = j + 1;
+                plp.row[j] = V(i, j);
+            }
+            plp.colno[d] = d + 1;
+            plp.row[d] = -1.0;
+            if (!add_constraintex(plp.lp, d + 1, plp.row.data(), plp.colno.data(), LE, 0.0)) {
+                plp.reset();
+                return false;
+            }
+        }
+        // the row of the query point
+        for (j = 0; j < d; j++) plp.row[j] = 0.0;
+        if (!add_constraintex(plp.lp, d + 1, plp.row.data(), plp.colno.data(), LE, 1.0)) {
+            plp.reset();
+            return false;
+        }
+        set_add_rowmode(plp.lp, FALSE);
+
+        for (j = 0; j < d + 1; j++) set_bounds(plp.lp, j + 1, -infinite, infinite);
+        set_verbose(plp.lp, NEUTRAL);
+    }
+
+    for (j = 0; j < d; j++) plp.row[j] = q[j];
+    plp.row[d] = -1.0;
+    set_rowex(plp.lp, m + 1, d + 1, plp.row.data(), plp.colno.data());
+    set_obj_fnex(plp.lp, d + 1, plp.row.data(), plp.colno.data());
+
+    if (plp.solve(true, false) != OPTIMAL) return false;
+    return get_objective(plp.lp) <= 0.0;
+}
+
 
 #endif
@@ -0,0 +1,360 @@
+// VolEsti (volume computation and sampling library)
+
+// Copyright (c) 2012-2020 Vissarion Fisikopoulos
+// Copyright (c) 2018-2020 Apostolos Chalkis
+
+// Licensed under GNU LGPL.3, see LICENCE file
+
+#ifndef ZPOLY_ACTIVE_SET_H
+#define ZPOLY_ACTIVE_SET_H
+
+#include <vector>
+#include <limits>
+#include <cmath>
+#include <Eigen/Eigen>
+
+
+// Ray-shooting in a zonotope Z = { G^T lambda : -1 <= lambda <= 1 } without lpsolve,
+// where the rows of G are the generators.
+// The LP   max (or min) s   s.t.  G^T lambda - s v = p,  -1 <= lambda <= 1
+// has d equality rows, thus it is solved by a bounded-variable primal simplex
+// method that keeps the inverse of the d x d basis matrix. The optimal basis, i.e.
+// the active set of the generators, is kept for the next call: along a billiard
+// trajectory the basis of the facet that the previous ray hit is feasible for
+// the next ray and a few pivots give the next facet.
+// The dual solution of the optimal basis is orthogonal to the generators of
+// the facet that the ray hits, that is the normal of the facet.
+template <typename NT>
+class ZonotopeActiveSet
+{
+public:
+    typedef Eigen::Matrix<NT, Eigen::Dynamic, Eigen::Dynamic> MT;
+    typedef Eigen::Matrix<NT, Eigen::Dynamic, 1>              VT;
+
+    ZonotopeActiveSet() {}
+
+    // drop the bases, e.g. when the generators change
+    void reset()
+    {
+        _state[0].valid = false;
+        _state[1].valid = false;
+    }
+
+    // maximize (maxi = true) or minimize s; return false if the simplex method
+    // fails, e.g. when p is not in Z, then the caller should fall back to the LP
+    bool solve(MT const& G, VT const& p, VT const& v, bool const& maxi, NT& s)
+    {
+        State& st = _state[maxi ? 0 : 1];
+        _G = &G;
+        _p = &p;
+        _v = &v;
+        _d = G.cols();
+        _m = G.rows();
+        _sign = maxi ? NT(1) : NT(-1);
+        _tol = NT(1e-9) * std::max(NT(1), G.cwiseAbs().maxCoeff());
+
+        _phase1 = true;
+        if (!st.valid || !warm_start(st) || simplex(st) != SIMPLEX_OPTIMAL) {
+            cold_start(st);
+            if (simplex(st) != SIMPLEX_OPTIMAL) {
+                _phase1 = false;
+                st.valid = false;
+                return false;
+            }
+        }
+        _phase1 = false;
+        if (simplex(st) != SIMPLEX_OPTIMAL || !check_residual(st)) {
+            st.valid = false;
+            return false;
+        }
+
+        st.valid = true;
+        st.v = v;
+        s = st.x(_m);
+        return true;
+    }
+
+    // the outer normal of the facet that the ray of the last solve hits
+    void get_normal(bool const& maxi, VT& normal) const
+    {
+        State const& st = _state[maxi ? 0 : 1];
+        normal.noalias() = -st.y;
+        normal.normalize();
+    }
+
+private:
+    enum { BASIC, AT_LOWER, AT_UPPER, AT_ZERO };
+    enum { SIMPLEX_OPTIMAL, SIMPLEX_INFEASIBLE, SIMPLEX_UNBOUNDED, SIMPLEX_ITERATION_LIMIT };
+
+    struct State
+    {
+        State() : valid(false) {}
+
+        bool             valid;
+        std::vector<int> basis;   // the variable of each row of the basis
+        std::vector<int> status;  // the status of each variable
+        VT               x;       // lambda, s and the d artificial variables
+        MT               Binv;    // the inverse of the basis matrix
+        VT               v;       // the direction of the ray of Binv
+        VT               y;       // the dual solution
+        VT               w;
+        VT               Gy;
+        VT               art;     // the signs of the artificial columns
+        int              updates;
+    };
+
+    // variables 0,...,m-1 are lambda, m is s and m+1,...,m+d are artificial;
+    // the artificial variables are fixed to zero, a positive one is infeasible
+    NT lower(int const& j) const
+    {
+        if (j < _m) return NT(-1);
+        if (j == _m) return -std::numeric_limits<NT>::infinity();
+        return NT(0);
+    }
+
+    NT upper(int const& j) const
+    {
+        if (j < _m) return NT(1);
+        if (j == _m) return std::numeric_limits<NT>::infinity();
+        return NT(0);
+    }
+
+    // the cost of variable j, in phase 1 the sum of the infeasibilities is minimized
+    NT cost(State const& st, int const& j) const
+    {
+        if (!_phase1) return (j == _m) ? _sign : NT(0);
+        if (st.status[j] != BASIC) return NT(0);
+        if (st.x(j) < lower(j) - _tol) return NT(1);
+        if (st.x(j) > upper(j) + _tol) return NT(-1);
+        return NT(0);
+    }
+
+    // w = Binv * (the column of variable j)
+    void column_solve(State& st, int const& j) const
+    {
+        if (j < _m) {
+            st.w.noalias() = st.Binv * _G->row(j).transpose();
+        } else if (j == _m) {
+            st.w.noalias() = -st.Binv * (*_v);
+        } else {
+            st.w = st.art(j - _m - 1) * st.Binv.col(j - _m - 1);
+        }
+    }
+
+    // the basic variables for the nonbasic ones at their bounds
+    void compute_basic(State& st) const
+    {
+        VT r = *_p;
+        for (int j = 0; j < _m; j++) {
+            if (st.status[j] != BASIC && st.x(j) != NT(0)) r.noalias() -= st.x(j) * _G->row(j).transpose();
+        }
+        if (st.status[_m] != BASIC) r.noalias() += st.x(_m) * (*_v);
+        VT xB = st.Binv * r;
+        for (int i = 0; i < _d; i++) st.x(st.basis[i]) = xB(i);
+    }
+
+    bool refactor(State& st) const
+    {
+        MT B(_d, _d);
+        for (int i = 0; i < _d; i++) {
+            int j = st.basis[i];
+            if (j < _m) {
+                B.col(i) = _G->row(j).transpose();
+            } else if (j == _m) {
+                B.col(i) = -(*_v);
+            } else {
+                B.col(i).setZero();
+                B(j - _m - 1, i) = st.art(j - _m - 1);
+            }
+        }
+        Eigen::FullPivLU<MT> lu(B);
+        if (!lu.isInvertible()) return false;
+        st.Binv = lu.inverse();
+        st.updates = 0;
+        compute_basic(st);
+        return true;
+    }
+
+    // start from the optimal basis of the previous call, only the column of s changes;
+    // the basis may be infeasible for the new ray, then phase 1 starts from it
+    bool warm_start(State& st)
+    {
+        int r = -1;
+        for (int i = 0; i < _d; i++) {
+            if (st.basis[i] == _m) r = i;
+        }
+        if (r >= 0) {
+            // Sherman-Morrison update of Binv for the new column -v
+            VT u = st.v - *_v;
+            st.w.noalias() = st.Binv * u;
+            NT denom = NT(1) + st.w(r);
+            if (std::abs(denom) < NT(1e-8) || st.updates > 100) {
+                if (!refactor(st)) return false;
+            } else {
+                VT row = st.Binv.row(r).transpose();
+                st.Binv.noalias() -= (st.w / denom) * row.transpose();
+                st.updates++;
+                compute_basic(st);
+            }
+        } else {
+            st.x(_m) = NT(0);
+            compute_basic(st);
+        }
+        return true;
+    }
+
+    // the basis of the artificial variables, with lambda = -1 and s = 0
+    void cold_start(State& st)
+    {
+        int n = _m + 1 + _d;
+        st.basis.resize(_d);
+        st.status.resize(n);
+        st.x.setZero(n);
+        st.art.resize(_d);
+        st.Binv.setZero(_d, _d);
+        st.updates = 0;
+
+        for (int j = 0; j < _m; j++) {
+            st.status[j] = AT_LOWER;
+            st.x(j) = NT(-1);
+        }
+        st.status[_m] = AT_ZERO;
+
+        VT r = *_p + _G->colwise().sum().transpose();
+        for (int i = 0; i < _d; i++) {
+            st.art(i) = (r(i) < NT(0)) ? NT(-1) : NT(1);
+            st.basis[i] = _m + 1 + i;
+            st.status[_m + 1 + i] = BASIC;
+            st.x(_m + 1 + i) = std::abs(r(i));
+            st.Binv(i, i) = st.art(i);
+        }
+    }
+
+    // the primal simplex method, Dantzig's rule and Bland's rule after degenerate pivots;
+    // phase 1 stops at the first feasible basis
+    int simplex(State& st)
+    {
+        const NT inf = std::numeric_limits<NT>::infinity();
+        const int max_iter = 20 * (_m + _d) + 100;
+        int degenerate = 0;
+        bool flipped = false;
+        VT cB(_d);
+
+        for (int iter = 0; iter < max_iter; iter++)
+        {
+            if (st.updates > 100 && !refactor(st)) return SIMPLEX_ITERATION_LIMIT;
+
+            // in phase 2 a bound flip changes neither the basis nor the dual solution
+            if (_phase1 || !flipped) {
+                for (int i = 0; i < _d; i++) cB(i) = cost(st, st.basis[i]);
+                if (_phase1 && cB.isZero()) return SIMPLEX_OPTIMAL;
+                st.y.noalias() = st.Binv.transpose() * cB;
+                st.Gy.noalias() = (*_G) * st.y;
+            }
+            flipped = false;
+
+            // pricing, the artificial variables never enter the basis
+            int q = -1;
+            NT rc_q = NT(0), best = NT(0);
+            bool bland = degenerate > 50;
+            for (int j = 0; j <= _m; j++) {
+                if (st.status[j] == BASIC) continue;
+                NT rc = cost(st, j) - ((j < _m) ? st.Gy(j) : -_v->dot(st.y));
+                bool eligible = (st.status[j] == AT_LOWER && rc > _tol)
+                             || (st.status[j] == AT_UPPER && rc < -_tol)
+                             || (st.status[j] == AT_ZERO && std::abs(rc) > _tol);
+                if (eligible && std::abs(rc) > best) {
+                    q = j;
+                    rc_q = rc;
+                    best = std::abs(rc);
+                    if (bland) break;
+                }
+            }
+            if (q < 0) return _phase1 ? SIMPLEX_INFEASIBLE : SIMPLEX_OPTIMAL;
+
+            // ratio test
+            NT dir = (rc_q > NT(0)) ? NT(1) : NT(-1);
+            column_solve(st, q);
+            NT theta = upper(q) - lower(q);
+            int leave = -1;
+            bool to_lower = false;
+            for (int i = 0; i < _d; i++) {
+                NT wi = st.w(i);
+                if (std::abs(wi) <= _tol) continue;
+                int j = st.basis[i];
+                NT xj = st.x(j), delta = -dir * wi, t;
+                bool lower_bound;
+                if (xj < lower(j) - _tol) {
+                    // an infeasible variable blocks when it becomes feasible
+                    if (delta < NT(0)) continue;
+                    t = (lower(j) - xj) / delta;
+                    lower_bound = true;
+                } else if (xj > upper(j) + _tol) {
+                    if (delta > NT(0)) continue;
+                    t = (xj - upper(j)) / (-delta);
+                    lower_bound = false;
+                } else if (delta < NT(0)) {
+                    t = (xj - lower(j)) / (-delta);
+                    lower_bound = true;
+                } else {
+                    t = (upper(j) - xj) / delta;
+                    lower_bound = false;
+                }
+                if (t < NT(0)) t = NT(0);
+                if (t < theta - _tol
+                    || (t <= theta + _tol && leave >= 0 && std::abs(wi) > std::abs(st.w(leave)))) {
+                    theta = t;
+                    leave = i;
+                    to_lower = lower_bound;
+                }
+            }
+            if (theta == inf) return SIMPLEX_UNBOUNDED;
+            degenerate = (theta <= _tol) ? degenerate + 1 : 0;
+
+            st.x(q) += dir * theta;
+            for (int i = 0; i < _d; i++) st.x(st.basis[i]) -= dir * theta * st.w(i);
+
+            if (leave < 0) {
+                // the entering variable moves to its other bound
+                st.status[q] = (dir > NT(0)) ? AT_UPPER : AT_LOWER;
+                st.x(q) = (dir > NT(0)) ? upper(q) : lower(q);
+                flipped = true;
+                continue;
+            }
+
+            int j = st.basis[leave];
+            st.status[j] = to_lower ? AT_LOWER : AT_UPPER;
+            st.x(j) = to_lower ? lower(j) : upper(j);
+            st.basis[leave] = q;
+            st.status[q] = BASIC;
+
+            NT pivot = st.w(leave);
+            st.Binv.row(leave) /= pivot;
+            for (int i = 0; i < _d; i++) {
+                if (i != leave && st.w(i) != NT(0)) {
+                    st.Binv.row(i) -= st.w(i) * st.Binv.row(leave);
+                }
+            }
+            st.updates++;
+        }
+        return SIMPLEX_ITERATION_LIMIT;
+    }
+
+    // the solution should satisfy G^T lambda - s v = p
+    bool check_residual(State const& st) const
+    {
+        VT r = *_p + st.x(_m) * (*_v);
+        r.noalias() -= _G->transpose() * st.x.head(_m);
+        return r.norm() <= NT(1e-6) * std::max(NT(1), _p->norm());
+    }
+
+    State     _state[2];
+    MT const* _G;
+    VT const* _p;
+    VT const* _v;
+    int       _d, _m;
+    NT        _sign, _tol;
+    bool      _phase1;
+};
+
+#endif
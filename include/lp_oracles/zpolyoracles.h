@@ -27,6 +27,7 @@
 #undef Realloc
 #undef Free
 #include "lp_lib.h"
+#include "vpolyoracles.h"
 
 
 template <typename MT, typename Point, typename NT>
@@ -217,5 +218,54 @@ std::pair<NT,NT> intersect_line_zono(const MT &V, const Point &p, const Point &v
     return pair_res;
 }
 
+// as memLP_Zonotope, the LP is updated in place and warm-started
+template <typename MT, typename Point>
+bool memLP_Zonotope(PersistentLP& plp, const MT &V, const Point &q)
+{
+    int d = q.dimension(), Ncol = V.rows(), j;
+
+    if (plp.empty()) {
+        plp.lp = make_lp(0, Ncol);
+        if (plp.lp == NULL) return false;
+        plp.row.resize(Ncol);
+        plp.colno.resize(Ncol);
+
+        set_add_rowmode(plp.lp, TRUE);
+        for (int i = 0; i < d; ++i) {
+            for (j = 0; j < Ncol; j++) {
+                plp.colno[j] = j + 1;
+                plp.row[j] = V(j, i);
+            }
+            if (!add_constraintex(plp.lp, Ncol, plp.row.data(), plp.colno.data(), EQ, 0.0)) {
+                plp.reset();
+                return false;
+            }
+        }
+        set_add_rowmode(plp.lp, FALSE);
+
+        for (j = 0; j < Ncol; j++) set_bounds(plp.lp, j + 1, -1.0, 1.0);
+        set_verbose(plp.lp, NEUTRAL);
+    }
+
+    for (int i = 0; i < d; ++i) set_rh(plp.lp, i + 1, q[i]);
+    return plp.solve(true) == OPTIMAL;
+}
+
+
+// as intersect_line_zono, the LP is updated in place and warm-started
+template <typename NT, typename MT, typename Point>
+std::pair<NT,NT> intersect_line_zono(PersistentLP& plp, const MT &V, const Point &p, const Point &v)
+{
+    std::pair<NT,NT> pair_res;
+    if (plp.empty() && !build_ray_shooting_lp(plp, V, true)) return pair_res;
+
+    set_ray_shooting_lp(plp, p, v);
+    plp.solve(true);
+    pair_res.second = NT(-get_objective(plp.lp));
+    plp.solve(false);
+    pair_res.first = NT(-get_objective(plp.lp));
+    return pair_res;
+}
+
 
 #endif
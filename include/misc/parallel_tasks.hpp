@@ -0,0 +1,57 @@
+// VolEsti (volume computation and sampling library)
+
+// Copyright (c) 2012-2020 Vissarion Fisikopoulos
+// Copyright (c) 2018-2020 Apostolos Chalkis
+
+// Licensed under GNU LGPL.3, see LICENCE file
+
+#ifndef MISC_PARALLEL_TASKS_HPP
+#define MISC_PARALLEL_TASKS_HPP
+
+#include <limits>
+
+#include "generators/boost_random_number_generator.hpp"
+#include "misc/thread_pool.hpp"
+
+
+// Draw a seed from rng, to be used as the base seed of independent streams
+template <typename RandomNumberGenerator>
+unsigned int draw_stream_seed(RandomNumberGenerator &rng)
+{
+    return static_cast<unsigned int>(rng.sample_urdist()
+                                     * double(std::numeric_limits<unsigned int>::max()));
+}
+
+// Run task(i) for every i in [0, num_tasks) on at most n_threads threads of
+// pool, the calling thread is one of them. The tasks are handed out one by
+// one, thus tasks of different cost are balanced between the threads.
+template <typename Task>
+void run_parallel_for(unsigned int const& num_tasks,
+                      unsigned int const& n_threads,
+                      Task const& task,
+                      ThreadPool& pool = default_thread_pool())
+{
+    pool.parallel_for(num_tasks, n_threads, task);
+}
+
+// Run task(i, rng_i) for every i in [0, num_tasks) on at most n_threads threads.
+// The i-th task gets its own random number generator rng_i on the stream
+// (seed, i), thus its result depends neither on the number of threads nor on
+// the order that the tasks are scheduled.
+template <typename RandomNumberGenerator, typename Task>
+void run_parallel_tasks(unsigned int const& num_tasks,
+                        unsigned int const& n_threads,
+                        unsigned int const& dim,
+                        unsigned int const& seed,
+                        Task const& task,
+                        ThreadPool& pool = default_thread_pool())
+{
+    run_parallel_for(num_tasks, n_threads, [&](unsigned int i)
+    {
+        RandomNumberGenerator rng(dim);
+        rng.set_stream(seed, i);
+        task(i, rng);
+    }, pool);
+}
+
+#endif // MISC_PARALLEL_TASKS_HPP
@@ -0,0 +1,236 @@
+// VolEsti (volume computation and sampling library)
+
+// Copyright (c) 2012-2020 Vissarion Fisikopoulos
+// Copyright (c) 2018-2020 Apostolos Chalkis
+
+// Licensed under GNU LGPL.3, see LICENCE file
+
+#ifndef MISC_THREAD_POOL_HPP
+#define MISC_THREAD_POOL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+
+// A pool of worker threads that persist between the parallel regions of the
+// library. A parallel region (parallel_for) is posted as a job, the calling
+// thread works on it and the idle workers steal its tasks one by one. A task
+// may open a nested parallel region, that is served by the same workers, thus
+// nested regions never start threads and the host is not oversubscribed.
+class ThreadPool
+{
+public:
+
+    // num_workers threads besides the calling ones, if pin_threads is true
+    // the i-th worker is bound to the (i+1)-th cpu (Linux only)
+    explicit ThreadPool(unsigned int const& num_workers, bool pin_threads = false)
+        :   _stop(false)
+    {
+        for (unsigned int i = 0; i < num_workers; ++i)
+        {
+            _workers.push_back(std::thread([this]() { work(); }));
+            if (pin_threads) pin(_workers.back(), i + 1);
+        }
+    }
+
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stop = true;
+        }
+        _work_available.notify_all();
+        for (auto& worker : _workers) worker.join();
+    }
+
+    ThreadPool(ThreadPool const&) = delete;
+    ThreadPool& operator=(ThreadPool const&) = delete;
+
+    unsigned int num_workers() const
+    {
+        return _workers.size();
+    }
+
+    // Run task(i) for every i in [0, num_tasks) on at most max_threads threads,
+    // the calling thread included. It returns when all the tasks are done and
+    // rethrows the first exception thrown by a task.
+    template <typename Task>
+    void parallel_for(unsigned int const& num_tasks,
+                      unsigned int const& max_threads,
+                      Task const& task)
+    {
+        if (num_tasks == 0) return;
+        if (max_threads <= 1 || num_tasks == 1 || _workers.empty())
+        {
+            for (unsigned int i = 0; i < num_tasks; ++i) task(i);
+            return;
+        }
+
+        Job job(num_tasks, std::min(max_threads, num_tasks), &task, &invoke<Task>);
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _jobs.push_back(&job);
+        }
+        _work_available.notify_all();
+
+        run(job);
+
+        std::unique_lock<std::mutex> lock(_mutex);
+        _jobs.remove(&job);
+        _job_done.wait(lock, [&job]() { return job.num_threads == 0; });
+        lock.unlock();
+
+        if (job.error) std::rethrow_exception(job.error);
+    }
+
+private:
+
+    struct Job
+    {
+        Job(unsigned int const& tasks,
+            unsigned int const& threads,
+            void const* task_ptr,
+            void (*invoke_ptr)(void const*, unsigned int))
+            :   num_tasks(tasks), max_threads(threads), num_threads(1),
+                next_task(0), task(task_ptr), invoke(invoke_ptr)
+        {}
+
+        unsigned int num_tasks;
+        unsigned int max_threads;
+        unsigned int num_threads; // the threads that work on the job, guarded by _mutex
+        std::atomic<unsigned int> next_task;
+        void const* task;
+        void (*invoke)(void const*, unsigned int);
+        std::exception_ptr error; // guarded by _mutex
+    };
+
+    template <typename Task>
+    static void invoke(void const* task, unsigned int i)
+    {
+        (*static_cast<Task const*>(task))(i);
+    }
+
+    // execute the tasks of the job until none is left, then leave the job
+    void run(Job& job)
+    {
+        std::exception_ptr error;
+        for (unsigned int i = job.next_task++; i < job.num_tasks; i = job.next_task++)
+        {
+            try
+            {
+                job.invoke(job.task, i);
+            }
+            catch (...)
+            {
+                if (!error) error = std::current_exception();
+                job.next_task = job.num_tasks;
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (error && !job.error) job.error = error;
+        if (--job.num_threads == 0) _job_done.notify_all();
+    }
+
+    // a job with tasks left that accepts one more thread, _mutex is held
+    Job* find_job()
+    {
+        for (Job* job : _jobs)
+        {
+            if (job->next_task < job->num_tasks && job->num_threads < job->max_threads)
+            {
+                return job;
+            }
+        }
+        return nullptr;
+    }
+
+    void work()
+    {
+        while (true)
+        {
+            Job* job = nullptr;
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _work_available.wait(lock, [&]() {
+                    return _stop || (job = find_job()) != nullptr;
+                });
+                if (job == nullptr) return;
+                ++job->num_threads;
+            }
+            run(*job);
+        }
+    }
+
+    static void pin(std::thread& thread, unsigned int const& cpu)
+    {
+#if defined(__linux__)
+        unsigned int num_cpus = std::max(1u, std::thread::hardware_concurrency());
+        cpu_set_t cpuset;
+        CPU_ZERO(&cpuset);
+        CPU_SET(cpu % num_cpus, &cpuset);
+        pthread_setaffinity_np(thread.native_handle(), sizeof(cpu_set_t), &cpuset);
+#else
+        (void) thread;
+        (void) cpu;
+#endif
+    }
+
+    std::vector<std::thread> _workers;
+    std::list<Job*> _jobs;
+    std::mutex _mutex;
+    std::condition_variable _work_available;
+    std::condition_variable _job_done;
+    bool _stop;
+};
+
+
+inline std::mutex& default_thread_pool_mutex()
+{
+    static std::mutex mutex;
+    return mutex;
+}
+
+inline std::unique_ptr<ThreadPool>& default_thread_pool_instance()
+{
+    static std::unique_ptr<ThreadPool> pool;
+    return pool;
+}
+
+// Replace the pool used by the parallel routines of the library, e.g. with a
+// smaller one when the library is called by threads of an application. It
+// must not be called while a parallel routine is running.
+inline void set_default_thread_pool(unsigned int const& num_workers,
+                                    bool pin_threads = false)
+{
+    std::lock_guard<std::mutex> lock(default_thread_pool_mutex());
+    default_thread_pool_instance().reset(new ThreadPool(num_workers, pin_threads));
+}
+
+// The pool used by the parallel routines of the library, it is created at
+// the first call with one worker per cpu besides the calling thread
+inline ThreadPool& default_thread_pool()
+{
+    std::lock_guard<std::mutex> lock(default_thread_pool_mutex());
+    std::unique_ptr<ThreadPool>& pool = default_thread_pool_instance();
+    if (!pool)
+    {
+        unsigned int num_cpus = std::thread::hardware_concurrency();
+        pool.reset(new ThreadPool(num_cpus > 1 ? num_cpus - 1 : 0));
+    }
+    return *pool;
+}
+
+#endif // MISC_THREAD_POOL_HPP
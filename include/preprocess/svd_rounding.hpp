@@ -11,6 +11,9 @@
 #ifndef SVD_ROUNDING_HPP
 #define SVD_ROUNDING_HPP
 
+#include "misc/parallel_tasks.hpp"
+#include "sampling/point_matrix.hpp"
+
 
 template
 <
@@ -22,7 +25,9 @@ template
     typename RandomNumberGenerator
 >
 void svd_on_sample(Polytope &P, Point &p, unsigned int const& num_rounding_steps, MT &V, VT &s, VT &Means,
-                   unsigned int const& walk_length, RandomNumberGenerator &rng)
+                   unsigned int const& walk_length, RandomNumberGenerator &rng,
+                   unsigned int const& n_threads = 1,
+                   ThreadPool& pool = default_thread_pool())
 {
     typedef typename WalkTypePolicy::template Walk
             <
@@ -35,15 +40,37 @@ void svd_on_sample(Polytope &P, Point &p, unsigned int const& num_rounding_steps
 
     unsigned int N = num_rounding_steps;
 
-    std::list<Point> randPoints;
     MT RetMat(N, P.dimension());
-    RandomPointGenerator::apply(P, p, N, walk_length, randPoints,
-                                push_back_policy, rng);
 
-    int jj = 0;
-    for (typename std::list<Point>::iterator rpit = randPoints.begin(); rpit!=randPoints.end(); rpit++, jj++)
+    if (n_threads <= 1)
+    {
+        PointMatrix<Point> randPoints(P.dimension(), N);
+        RandomPointGenerator::apply(P, p, N, walk_length, randPoints,
+                                    push_back_policy, rng);
+        RetMat = randPoints.matrix().transpose();
+    }
+    else
     {
-        RetMat.row(jj) = (*rpit).getCoefficients().transpose();
+        // n_threads chains start from p, each one with its own copy of P and
+        // its own stream, and fill consecutive rows of RetMat
+        unsigned int seed = draw_stream_seed(rng);
+        std::vector<Point> last_points(n_threads, p);
+
+        run_parallel_for(n_threads, n_threads, [&](unsigned int t)
+        {
+            unsigned int first = t * (N / n_threads) + std::min(t, N % n_threads);
+            unsigned int t_N = N / n_threads + ((t < N % n_threads) ? 1 : 0);
+
+            Polytope P_t(P);
+            RandomNumberGenerator rng_t(P.dimension());
+            rng_t.set_stream(seed, t);
+            PushBackWalkPolicy push_back_policy_t;
+            PointMatrix<Point> randPoints(P.dimension(), t_N);
+            RandomPointGenerator::apply(P_t, last_points[t], t_N, walk_length,
+                                        randPoints, push_back_policy_t, rng_t);
+            RetMat.middleRows(first, t_N) = randPoints.matrix().transpose();
+        }, pool);
+        p = last_points[n_threads - 1];
     }
 
     for (int i = 0; i < P.dimension(); ++i) {
@@ -85,7 +112,9 @@ template
 std::tuple<MT, VT, NT> svd_rounding(Polytope &P,
                                     std::pair<Point,NT> &InnerBall,
                                     const unsigned int &walk_length,
-                                    RandomNumberGenerator &rng)
+                                    RandomNumberGenerator &rng,
+                                    unsigned int const& n_threads = 1,
+                                    ThreadPool& pool = default_thread_pool())
 {
     NT tol = 0.00000001;
     NT R = std::pow(10,10), r = InnerBall.second;
@@ -123,7 +152,7 @@ std::tuple<MT, VT, NT> svd_rounding(Polytope &P,
 
             p = InnerBall.first;
             svd_on_sample<WalkTypePolicy>(P, p, num_rounding_steps, V, s,
-                                          shift, walk_length, rng);
+                                          shift, walk_length, rng, n_threads, pool);
 
             rounding_samples = rounding_samples + num_rounding_steps;
             max_s = s.maxCoeff();
@@ -133,7 +162,7 @@ std::tuple<MT, VT, NT> svd_rounding(Polytope &P,
                     num_rounding_steps = num_rounding_steps * 2;
                     p = InnerBall.first;
                     svd_on_sample<WalkTypePolicy>(P, p, num_rounding_steps, V, s,
-                                                  shift, walk_length, rng);
+                                                  shift, walk_length, rng, n_threads, pool);
                     max_s = s.maxCoeff();
                 } else {
                     last_round_under_p = true;
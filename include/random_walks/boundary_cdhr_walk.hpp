@@ -9,6 +9,7 @@
 #define RANDOM_WALKS_BOUNDARY_CDHR_WALK_HPP
 
 #include "sampling/sphere.hpp"
+#include "random_walks/coordinate_oracle_state.hpp"
 
 // random directions hit-and-run walk with uniform target distribution
 // from boundary
@@ -44,14 +45,9 @@ struct BCDHRWalk
             std::pair<NT, NT> bpair;
             for (auto j = 0u; j < walk_length; ++j)
             {
-                auto rand_coord_prev = _rand_coord;
                 _rand_coord = rng.sample_uidist();
                 NT kapa = rng.sample_urdist();
-                bpair = P.line_intersect_coord(_p,
-                                               _p_prev,
-                                               _rand_coord,
-                                               rand_coord_prev,
-                                               _lamdas);
+                bpair = _oracle.line_intersect_coord(P, _p, _rand_coord);
                 _p_prev = _p;
                 _p.set_coord(_rand_coord, _p[_rand_coord] + bpair.first + kapa
                                           * (bpair.second - bpair.first));
@@ -69,12 +65,10 @@ struct BCDHRWalk
                                Point const& p,
                                RandomNumberGenerator& rng)
         {
-            _lamdas.setZero(P.num_of_hyperplanes());
             _rand_coord = rng.sample_uidist();
             NT kapa = rng.sample_urdist();
             _p = p;
-            std::pair<NT, NT> bpair = P.line_intersect_coord(_p, _rand_coord,
-                                                             _lamdas);
+            std::pair<NT, NT> bpair = _oracle.initialize(P, _p, _rand_coord);
             _p_prev = _p;
             _p.set_coord(_rand_coord, _p[_rand_coord] + bpair.first + kapa
                                       * (bpair.second - bpair.first));
@@ -83,7 +77,7 @@ struct BCDHRWalk
         unsigned int _rand_coord;
         Point _p;
         Point _p_prev;
-        typename Point::Coeff _lamdas;
+        CoordinateOracleState<Polytope> _oracle;
     };
 
 };
@@ -75,8 +75,8 @@ struct BRDHRWalk
 
         Point _p;
         NT _lambda;
-        typename Point::Coeff _lamdas;
-        typename Point::Coeff _Av;
+        typename Polytope::VT _lamdas;
+        typename Polytope::VT _Av;
     };
 
 };
@@ -0,0 +1,74 @@
+// VolEsti (volume computation and sampling library)
+
+// Copyright (c) 2012-2020 Vissarion Fisikopoulos
+// Copyright (c) 2018-2020 Apostolos Chalkis
+
+// Licensed under GNU LGPL.3, see LICENCE file
+
+#ifndef RANDOM_WALKS_COORDINATE_ORACLE_STATE_HPP
+#define RANDOM_WALKS_COORDINATE_ORACLE_STATE_HPP
+
+#include <utility>
+
+
+// The state of the coordinate boundary oracle of a convex body that the
+// coordinate directions hit-and-run walks carry between their steps: the
+// vector lamdas of the bodies with incremental oracles (b - Ap for H-polytopes),
+// and the point, the coordinate and the chord of the last oracle call.
+// Any body works with it since it only calls line_intersect_coord.
+//
+// A step along the coordinate of the previous step stays on the same line,
+// so its chord is the previous chord shifted and the oracle is not called.
+// That skips 1/d of the LPs of V-polytopes, zonotopes and their intersections.
+// The next oracle call of an incremental body updates lamdas with the move
+// from the point of the last call, which is along the same coordinate.
+template <typename Polytope>
+class CoordinateOracleState
+{
+    typedef typename Polytope::PointType Point;
+    typedef typename Point::FT NT;
+    typedef typename Polytope::VT VT;
+
+public:
+    // the chord of the line through p that is parallel to the rand_coord axis,
+    // a new walk (or a new starting point) starts with this call
+    template <typename GenericBody>
+    std::pair<NT, NT> initialize(GenericBody const& P,
+                                 Point const& p,
+                                 unsigned int const& rand_coord)
+    {
+        _lamdas.setZero(P.num_of_hyperplanes());
+        _chord = P.line_intersect_coord(p, rand_coord, _lamdas);
+        _p_prev = p;
+        _rand_coord = rand_coord;
+        return _chord;
+    }
+
+    // as initialize, p differs from the point of the previous call only in
+    // coordinates that the walk has moved along since that call
+    template <typename GenericBody>
+    std::pair<NT, NT> line_intersect_coord(GenericBody const& P,
+                                           Point const& p,
+                                           unsigned int const& rand_coord)
+    {
+        if (rand_coord == _rand_coord)
+        {
+            NT shift = p[rand_coord] - _p_prev[rand_coord];
+            return std::make_pair(_chord.first - shift, _chord.second - shift);
+        }
+        _chord = P.line_intersect_coord(p, _p_prev, rand_coord, _rand_coord,
+                                        _lamdas);
+        _p_prev = p;
+        _rand_coord = rand_coord;
+        return _chord;
+    }
+
+private:
+    Point _p_prev;
+    unsigned int _rand_coord;
+    std::pair<NT, NT> _chord;
+    VT _lamdas;
+};
+
+
+#endif // RANDOM_WALKS_COORDINATE_ORACLE_STATE_HPP
@@ -54,6 +54,7 @@ struct Walk
 
     Walk (Polytope const& P, Point const& p, NT const& a,
           RandomNumberGenerator &rng)
+        :   _y(P.dimension())
     {
         _delta = compute_delta(P, a);
     }
@@ -63,6 +64,7 @@ struct Walk
           NT const& a,
           RandomNumberGenerator &rng,
           parameters const& params)
+        :   _y(P.dimension())
     {
         _delta = params.set_delta ? params.m_L
                                   : compute_delta(P, a);
@@ -77,17 +79,15 @@ struct Walk
     {
         for (auto j = 0u; j < walk_length; ++j)
         {
-            Point y = GetPointInDsphere<Point>::apply(P.dimension(),
-                                                      _delta,
-                                                      rng);
-            y += p;
-            if (P.is_in(y) == -1)
+            GetPointInDsphere<Point>::apply(P.dimension(), _delta, rng, _y);
+            _y += p;
+            if (P.is_in(_y) == -1)
             {
                 NT f_x = eval_exp(p, a_i);
-                NT f_y = eval_exp(y, a_i);
+                NT f_y = eval_exp(_y, a_i);
                 NT rnd = rng.sample_urdist();
                 if (rnd <= f_y / f_x) {
-                    p = y;
+                    p = _y;
                 }
             }
         }
@@ -100,6 +100,7 @@ struct Walk
 
 private :
     NT _delta;
+    Point _y;
 };
 
 };
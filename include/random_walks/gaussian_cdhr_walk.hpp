@@ -9,6 +9,7 @@
 #define RANDOM_WALKS_GAUSSIAN_CDHR_WALK_HPP
 
 #include "sampling/sphere.hpp"
+#include "random_walks/coordinate_oracle_state.hpp"
 #include "generators/boost_random_number_generator.hpp"
 #include "random_walks/gaussian_helpers.hpp"
 
@@ -104,18 +105,14 @@ struct Walk
     {
         for (auto j = 0u; j < walk_length; ++j)
         {
-            auto rand_coord_prev = _rand_coord;
-            _rand_coord = rng.sample_uidist();
-            std::pair <NT, NT> bpair =
-                    P.line_intersect_coord(_p, _p_prev, _rand_coord,
-                                           rand_coord_prev, _lamdas);
+            unsigned int rand_coord = rng.sample_uidist();
+            std::pair <NT, NT> bpair = _oracle.line_intersect_coord(P, _p, rand_coord);
             NT dis = chord_random_point_generator_exp_coord
-                        (_p[_rand_coord] + bpair.second,
-                         _p[_rand_coord] + bpair.first,
+                        (_p[rand_coord] + bpair.second,
+                         _p[rand_coord] + bpair.first,
                          a_i,
                          rng);
-            _p_prev = _p;
-            _p.set_coord(_rand_coord, dis);
+            _p.set_coord(rand_coord, dis);
         }
         p = _p;
     }
@@ -128,22 +125,18 @@ private :
                            NT const& a_i,
                            RandomNumberGenerator &rng)
     {
-        _lamdas.setZero(P.num_of_hyperplanes());
-        _rand_coord = rng.sample_uidist();
+        unsigned int rand_coord = rng.sample_uidist();
         _p = p;
-        std::pair <NT, NT> bpair = P.line_intersect_coord(_p, _rand_coord, _lamdas);
+        std::pair <NT, NT> bpair = _oracle.initialize(P, _p, rand_coord);
         NT dis = chord_random_point_generator_exp_coord
-                    (_p[_rand_coord] + bpair.second,
-                     _p[_rand_coord] + bpair.first,
+                    (_p[rand_coord] + bpair.second,
+                     _p[rand_coord] + bpair.first,
                      a_i, rng);
-        _p_prev = p;
-        _p.set_coord(_rand_coord, dis);
+        _p.set_coord(rand_coord, dis);
     }
 
-    unsigned int _rand_coord;
     Point _p;
-    Point _p_prev;
-    typename Point::Coeff _lamdas;
+    CoordinateOracleState<Polytope> _oracle;
 };
 
 };
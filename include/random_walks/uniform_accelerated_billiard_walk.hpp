@@ -11,8 +11,35 @@
 #define RANDOM_WALKS_ACCELERATED_IMPROVED_BILLIARD_WALK_HPP
 
 #include "sampling/sphere.hpp"
+#include "convex_bodies/sparse_hpolytope.h"
 
 
+// The matrix A*A^T that updates A*v after each reflection,
+// it is kept sparse for sparse H-polytopes
+template <typename Polytope>
+struct compute_AA
+{
+    typedef typename Polytope::MT type;
+
+    template <typename GenericPolytope>
+    static void apply(GenericPolytope const& P, type& AA)
+    {
+        AA.noalias() = P.get_mat() * P.get_mat().transpose();
+    }
+};
+
+template <typename Point>
+struct compute_AA<SparseHPolytope<Point>>
+{
+    typedef typename SparseHPolytope<Point>::SpMT type;
+
+    template <typename GenericPolytope>
+    static void apply(GenericPolytope const& P, type& AA)
+    {
+        AA = P.get_AA();
+    }
+};
+
 // Billiard walk which accelarates each step for uniform distribution
 
 struct AcceleratedBilliardWalk
@@ -65,7 +92,7 @@ struct AcceleratedBilliardWalk
             _update_parameters = update_parameters();
             _L = compute_diameter<GenericPolytope>
                 ::template compute<NT>(P);
-            _AA.noalias() = P.get_mat() * P.get_mat().transpose();
+            compute_AA<Polytope>::apply(P, _AA);
             initialize(P, p, rng);
         }
 
@@ -77,7 +104,7 @@ struct AcceleratedBilliardWalk
             _L = params.set_L ? params.m_L
                               : compute_diameter<GenericPolytope>
                                 ::template compute<NT>(P);
-            _AA.noalias() = P.get_mat() * P.get_mat().transpose();
+            compute_AA<Polytope>::apply(P, _AA);
             initialize(P, p, rng);
         }
 
@@ -98,19 +125,19 @@ struct AcceleratedBilliardWalk
             for (auto j=0u; j<walk_length; ++j)
             {
                 T = -std::log(rng.sample_urdist()) * _L;
-                _v = GetDirection<Point>::apply(n, rng);
-                Point p0 = _p;
+                GetDirection<Point>::apply(n, rng, _v);
+                _p0 = _p;
 
                 it = 0;
                 std::pair<NT, int> pbpair = P.line_positive_intersect(_p, _v, _lambdas, _Av, _lambda_prev, _update_parameters);
                 if (T <= pbpair.first) {
-                    _p += (T * _v);
+                    _p += T * _v.getCoefficients();
                     _lambda_prev = T;
                     continue;
                 }
 
                 _lambda_prev = dl * pbpair.first;
-                _p += (_lambda_prev * _v);
+                _p += _lambda_prev * _v.getCoefficients();
                 T -= _lambda_prev;
                 P.compute_reflection(_v, _p, _update_parameters);
                 it++;
@@ -120,17 +147,17 @@ struct AcceleratedBilliardWalk
                     std::pair<NT, int> pbpair
                             = P.line_positive_intersect(_p, _v, _lambdas, _Av, _lambda_prev, _AA, _update_parameters);
                     if (T <= pbpair.first) {
-                        _p += (T * _v);
+                        _p += T * _v.getCoefficients();
                         _lambda_prev = T;
                         break;
                     }
                     _lambda_prev = dl * pbpair.first;
-                    _p += (_lambda_prev * _v);
+                    _p += _lambda_prev * _v.getCoefficients();
                     T -= _lambda_prev;
                     P.compute_reflection(_v, _p, _update_parameters);
                     it++;
                 }
-                if (it == 100*n) _p = p0;
+                if (it == 100*n) _p = _p0;
             }
             p = _p;
         }
@@ -196,12 +223,13 @@ struct AcceleratedBilliardWalk
 
         double _L;
         Point _p;
+        Point _p0;
         Point _v;
         NT _lambda_prev;
-        MT _AA;
+        typename compute_AA<Polytope>::type _AA;
         update_parameters _update_parameters;
-        typename Point::Coeff _lambdas;
-        typename Point::Coeff _Av;
+        typename Polytope::VT _lambdas;
+        typename Polytope::VT _Av;
     };
 
 };
@@ -48,6 +48,7 @@ struct BallWalk
         template <typename GenericPolytope>
         Walk(GenericPolytope const& P, Point const& /*p*/,
              RandomNumberGenerator& /*rng*/)
+            :   _y(P.dimension())
         {
             _delta = compute_delta(P);
         }
@@ -55,6 +56,7 @@ struct BallWalk
         template <typename GenericPolytope>
         Walk(GenericPolytope const& P, Point const& /*p*/,
              RandomNumberGenerator& /*rng*/, parameters const& params)
+            :   _y(P.dimension())
         {
             _delta = params.set_delta ? params.m_L
                                       : compute_delta(P);
@@ -75,11 +77,9 @@ struct BallWalk
         {
             for (auto j = 0u; j < walk_length; ++j)
             {
-                Point y = GetPointInDsphere<Point>::apply(P.dimension(),
-                                                          _delta,
-                                                          rng);
-                y += p;
-                if (P.is_in(y) == -1) p = y;
+                GetPointInDsphere<Point>::apply(P.dimension(), _delta, rng, _y);
+                _y += p;
+                if (P.is_in(_y) == -1) p = _y;
             }
         }
 
@@ -90,6 +90,7 @@ struct BallWalk
 
     private:
         double _delta;
+        Point _y;
     };
 };
 
@@ -15,6 +15,7 @@
 #include "convex_bodies/ball.h"
 #include "convex_bodies/ballintersectconvex.h"
 #include "convex_bodies/hpolytope.h"
+#include "convex_bodies/sparse_hpolytope.h"
 #ifndef VOLESTIPY
     #include "convex_bodies/vpolytope.h"
     #include "convex_bodies/vpolyintersectvpoly.h"
@@ -45,6 +46,17 @@ static NT compute(HPolytope<Point> const& P)
 }
 };
 
+template <typename Point>
+struct compute_diameter<SparseHPolytope<Point>>
+{
+template <typename NT>
+static NT compute(SparseHPolytope<Point> const& P)
+{
+    NT diameter = NT(2) * std::sqrt(NT(P.dimension())) * P.InnerBall().second;
+    return diameter;
+}
+};
+
 #ifndef VOLESTIPY
 template <typename Point>
 struct compute_diameter<VPolytope<Point>>
@@ -248,26 +260,26 @@ struct Walk
         for (auto j=0u; j<walk_length; ++j)
         {
             T = rng.sample_urdist() * _Len;
-            _v = GetDirection<Point>::apply(n, rng);
-            Point p0 = _p;
+            GetDirection<Point>::apply(n, rng, _v);
+            _p0 = _p;
             int it = 0;
             while (it < 50*n)
             {
                 auto pbpair = P.line_positive_intersect(_p, _v, _lambdas,
                                                         _Av, _lambda_prev);
                 if (T <= pbpair.first) {
-                    _p += (T * _v);
+                    _p += T * _v.getCoefficients();
                     _lambda_prev = T;
                     break;
                 }
                 _lambda_prev = dl * pbpair.first;
-                _p += (_lambda_prev * _v);
+                _p += _lambda_prev * _v.getCoefficients();
                 T -= _lambda_prev;
                 P.compute_reflection(_v, _p, pbpair.second);
                 it++;
             }
             if (it == 50*n){
-                _p = p0;
+                _p = _p0;
             }
         }
         p = _p;
@@ -334,10 +346,11 @@ private :
 
     NT _Len;
     Point _p;
+    Point _p0;
     Point _v;
     NT _lambda_prev;
-    typename Point::Coeff _lambdas;
-    typename Point::Coeff _Av;
+    typename Polytope::VT _lambdas;
+    typename Polytope::VT _Av;
 };
 
 };
@@ -11,6 +11,7 @@
 #define RANDOM_WALKS_UNIFORM_CDHR_WALK_HPP
 
 #include "sampling/sphere.hpp"
+#include "random_walks/coordinate_oracle_state.hpp"
 
 // random directions hit-and-run walk with uniform target distribution
 struct CDHRWalk
@@ -52,16 +53,10 @@ struct Walk
     {
         for (auto j=0u; j<walk_length; ++j)
         {
-            auto rand_coord_prev = _rand_coord;
-            _rand_coord = rng.sample_uidist();
+            unsigned int rand_coord = rng.sample_uidist();
             NT kapa = rng.sample_urdist();
-            std::pair<NT, NT> bpair = P.line_intersect_coord(_p,
-                                                             _p_prev,
-                                                             _rand_coord,
-                                                             rand_coord_prev,
-                                                             _lamdas);
-            _p_prev = _p;
-            _p.set_coord(_rand_coord, _p[_rand_coord] + bpair.first + kapa
+            std::pair<NT, NT> bpair = _oracle.line_intersect_coord(P, _p, rand_coord);
+            _p.set_coord(rand_coord, _p[rand_coord] + bpair.first + kapa
                          * (bpair.second - bpair.first));
         }
         p = _p;
@@ -74,20 +69,16 @@ private :
                            Point const& p,
                            RandomNumberGenerator &rng)
     {
-        _lamdas.setZero(P.num_of_hyperplanes());
-        _rand_coord = rng.sample_uidist();
+        unsigned int rand_coord = rng.sample_uidist();
         NT kapa = rng.sample_urdist();
         _p = p;
-        std::pair<NT, NT> bpair = P.line_intersect_coord(_p, _rand_coord, _lamdas);
-        _p_prev = _p;
-        _p.set_coord(_rand_coord, _p[_rand_coord] + bpair.first + kapa
+        std::pair<NT, NT> bpair = _oracle.initialize(P, _p, rand_coord);
+        _p.set_coord(rand_coord, _p[rand_coord] + bpair.first + kapa
                     * (bpair.second - bpair.first));
     }
 
-    unsigned int _rand_coord;
     Point _p;
-    Point _p_prev;
-    typename Point::Coeff _lamdas;
+    CoordinateOracleState<Polytope> _oracle;
 };
 
 };
@@ -0,0 +1,204 @@
+// VolEsti (volume computation and sampling library)
+
+// Copyright (c) 2012-2020 Vissarion Fisikopoulos
+// Copyright (c) 2018-2020 Apostolos Chalkis
+
+// Licensed under GNU LGPL.3, see LICENCE file
+
+#ifndef RANDOM_WALKS_UNIFORM_MULTI_BILLIARD_WALK_HPP
+#define RANDOM_WALKS_UNIFORM_MULTI_BILLIARD_WALK_HPP
+
+#include <vector>
+#include <Eigen/Eigen>
+
+#include "random_walks/uniform_billiard_walk.hpp"
+
+
+// Billiard walk for uniform distribution that advances N chains in lock-step.
+// The state of the chains is kept in structure-of-arrays form, i.e. the
+// i-th column of each matrix (resp. the i-th entry of each vector) belongs
+// to the i-th chain. The directions of all the chains are multiplied by A
+// with one matrix-matrix product per step and after a reflection A*v is
+// updated with the precomputed A*A^T, as in the accelerated billiard walk.
+// Only H-polytopes are supported.
+
+struct MultiBilliardWalk
+{
+    MultiBilliardWalk(double L)
+            :   param(L, true)
+    {}
+
+    MultiBilliardWalk()
+            :   param(0, false)
+    {}
+
+    struct parameters
+    {
+        parameters(double L, bool set)
+                :   m_L(L), set_L(set)
+        {}
+        double m_L;
+        bool set_L;
+    };
+
+    parameters param;
+
+
+template
+<
+    typename Polytope,
+    typename RandomNumberGenerator
+>
+struct Walk
+{
+    typedef typename Polytope::PointType Point;
+    typedef typename Polytope::MT MT;
+    typedef typename Polytope::VT VT;
+    typedef typename Point::FT NT;
+    typedef Eigen::Matrix<int, Eigen::Dynamic, 1> VTint;
+
+    // the columns of X are the starting points of the chains
+    template <typename GenericPolytope>
+    Walk(GenericPolytope const& P, MT const& X, RandomNumberGenerator &)
+    {
+        _L = compute_diameter<GenericPolytope>
+                ::template compute<NT>(P);
+        initialize(P, X);
+    }
+
+    template <typename GenericPolytope>
+    Walk(GenericPolytope const& P, MT const& X, RandomNumberGenerator &,
+         parameters const& params)
+    {
+        _L = params.set_L ? params.m_L
+                          : compute_diameter<GenericPolytope>
+                            ::template compute<NT>(P);
+        initialize(P, X);
+    }
+
+    template
+    <
+        typename GenericPolytope
+    >
+    inline void apply(GenericPolytope const& P,
+                      MT& X,   // the current points of the chains
+                      unsigned int const& walk_length,
+                      RandomNumberGenerator &rng)
+    {
+        unsigned int n = P.dimension();
+        int N = _X.cols();
+        const NT dl = 0.995;
+
+        for (auto j=0u; j<walk_length; ++j)
+        {
+            for (int i = 0; i < N; ++i)
+            {
+                _T(i) = rng.sample_urdist() * _L;
+                for (unsigned int k = 0; k < n; ++k)
+                {
+                    _V(k, i) = rng.sample_ndist();
+                }
+                _V.col(i) /= _V.col(i).norm();
+            }
+            _X0 = _X;
+            _AX0 = _AX;
+            P.compute_AV(_V, _AV);
+            _it.setZero();
+
+            _active.resize(N);
+            for (int i = 0; i < N; ++i) _active[i] = i;
+
+            while (!_active.empty())
+            {
+                // first compute the boundary points of all the active chains
+                for (auto i : _active)
+                {
+                    std::pair<NT, int> pbpair = P.line_positive_intersect(_AX, _AV, i);
+                    _lambdas(i) = pbpair.first;
+                    _facets(i) = pbpair.second;
+                }
+
+                // then move every chain and reflect the ones that hit the boundary
+                auto ait = _active.begin();
+                while (ait != _active.end())
+                {
+                    int i = *ait;
+                    if (_T(i) <= _lambdas(i))
+                    {
+                        move(i, _T(i));
+                    } else if (++_it(i) == 50*n)
+                    {
+                        _X.col(i) = _X0.col(i);
+                        _AX.col(i) = _AX0.col(i);
+                    } else
+                    {
+                        NT lambda = dl * _lambdas(i);
+                        move(i, lambda);
+                        _T(i) -= lambda;
+                        P.compute_reflection(_V, _AV, _AA, i, _facets(i));
+                        ++ait;
+                        continue;
+                    }
+                    *ait = _active.back();
+                    _active.pop_back();
+                }
+            }
+        }
+        X = _X;
+    }
+
+    inline void update_delta(NT L)
+    {
+        _L = L;
+    }
+
+    int num_of_chains() const
+    {
+        return _X.cols();
+    }
+
+private :
+
+    template
+    <
+        typename GenericPolytope
+    >
+    inline void initialize(GenericPolytope const& P, MT const& X)
+    {
+        int N = X.cols(), m = P.num_of_hyperplanes();
+        _X = X;
+        _V.setZero(P.dimension(), N);
+        _AV.setZero(m, N);
+        P.compute_AV(_X, _AX);
+        _AA = P.get_AA();
+        _T.setZero(N);
+        _lambdas.setZero(N);
+        _facets.setZero(N);
+        _it.setZero(N);
+    }
+
+    inline void move(int const& i, NT const& lambda)
+    {
+        _X.col(i).noalias() += lambda * _V.col(i);
+        _AX.col(i).noalias() += lambda * _AV.col(i);
+    }
+
+    NT _L;
+    MT _X;
+    MT _V;
+    MT _AX;
+    MT _AV;
+    MT _X0;
+    MT _AX0;
+    MT _AA;
+    VT _T;
+    VT _lambdas;
+    VTint _facets;
+    VTint _it;
+    std::vector<int> _active;
+};
+
+};
+
+
+#endif // RANDOM_WALKS_UNIFORM_MULTI_BILLIARD_WALK_HPP
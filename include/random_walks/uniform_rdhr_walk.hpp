@@ -54,12 +54,12 @@ struct Walk
     {
         for (auto j=0u; j<walk_length; ++j)
         {
-            Point v = GetDirection<Point>::apply(p.dimension(), rng);
-            std::pair<NT, NT> bpair = P.line_intersect(_p, v, _lamdas, _Av,
+            _directions.next(p.dimension(), rng, _v);
+            std::pair<NT, NT> bpair = P.line_intersect(_p, _v, _lamdas, _Av,
                                                        _lambda);
             _lambda = rng.sample_urdist() * (bpair.first - bpair.second)
                     + bpair.second;
-            _p += (_lambda * v);
+            _p += _lambda * _v.getCoefficients();
         }
         p = _p;
     }
@@ -74,16 +74,19 @@ private :
         _lamdas.setZero(P.num_of_hyperplanes());
         _Av.setZero(P.num_of_hyperplanes());
 
-        Point v = GetDirection<Point>::apply(p.dimension(), rng);
-        std::pair<NT, NT> bpair = P.line_intersect(p, v, _lamdas, _Av);
+        _v = Point(p.dimension());
+        _directions.next(p.dimension(), rng, _v);
+        std::pair<NT, NT> bpair = P.line_intersect(p, _v, _lamdas, _Av);
         _lambda = rng.sample_urdist() * (bpair.first - bpair.second) + bpair.second;
-        _p = (_lambda * v) + p;
+        _p = (_lambda * _v) + p;
     }
 
     Point _p;
+    Point _v;
+    DirectionBuffer<Point> _directions;
     NT _lambda;
-    typename Point::Coeff _lamdas;
-    typename Point::Coeff _Av;
+    typename Polytope::VT _lamdas;
+    typename Polytope::VT _Av;
 };
 
 };
@@ -0,0 +1,273 @@
+// VolEsti (volume computation and sampling library)
+
+// Copyright (c) 2012-2020 Vissarion Fisikopoulos
+// Copyright (c) 2018-2020 Apostolos Chalkis
+
+// Licensed under GNU LGPL.3, see LICENCE file
+
+#ifndef SAMPLERS_POINT_MATRIX_HPP
+#define SAMPLERS_POINT_MATRIX_HPP
+
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+#include <Eigen/Eigen>
+
+
+template <typename Point> class HPolytope;
+template <typename Point> struct Ball;
+
+
+// A list of points stored as the columns of one column-major matrix that
+// grows geometrically, to be used in place of std::list<Point> by the
+// samplers (push_back, clear, size, begin, end). The points are contiguous,
+// so matrix() is a view that rounding and the diagnostics consume without
+// copying and an H-polytope tests all of them with one product A*X.
+//
+// The iterators copy the column into a point they own and return a reference
+// to it, the reference is valid until the iterator moves.
+template <typename Point>
+class PointMatrix
+{
+    typedef typename Point::FT NT;
+    typedef Eigen::Matrix<NT, Eigen::Dynamic, Eigen::Dynamic> MT;
+
+public:
+    typedef Point value_type;
+    typedef Eigen::Block<const MT, Eigen::Dynamic, Eigen::Dynamic, true> MatrixView;
+
+    class const_iterator
+    {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef Point value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef Point const* pointer;
+        typedef Point const& reference;
+
+        const_iterator() : _points(nullptr), _index(0), _has_point(false) {}
+
+        const_iterator(PointMatrix const* points, unsigned int const& index)
+            :   _points(points), _index(index), _has_point(false)
+        {}
+
+        Point const& operator*() const
+        {
+            unsigned int dim = _points->dimension();
+            if (!_has_point)
+            {
+                _point = Point(dim);
+                _has_point = true;
+            }
+            const NT* column = _points->_points.data() + std::size_t(_index) * dim;
+            std::copy(column, column + dim, _point.pointerToData());
+            return _point;
+        }
+
+        Point const* operator->() const
+        {
+            return &(**this);
+        }
+
+        const_iterator& operator++()
+        {
+            ++_index;
+            return *this;
+        }
+
+        const_iterator operator++(int)
+        {
+            const_iterator it = *this;
+            ++_index;
+            return it;
+        }
+
+        bool operator==(const_iterator const& other) const
+        {
+            return _index == other._index;
+        }
+
+        bool operator!=(const_iterator const& other) const
+        {
+            return _index != other._index;
+        }
+
+        unsigned int index() const
+        {
+            return _index;
+        }
+
+    private:
+        PointMatrix const* _points;
+        unsigned int _index;
+        mutable Point _point;
+        mutable bool _has_point;
+    };
+
+    typedef const_iterator iterator;
+
+    PointMatrix() : _dim(0), _size(0) {}
+
+    PointMatrix(unsigned int const& dim, unsigned int const& capacity = 0)
+        :   _points(dim, capacity), _dim(dim), _size(0)
+    {}
+
+    void push_back(Point const& p)
+    {
+        if (_size == 0 && _dim != (unsigned int) p.dimension())
+        {
+            _dim = p.dimension();
+            _points.resize(_dim, std::max(Eigen::Index(16), _points.cols()));
+        }
+        if (Eigen::Index(_size) == _points.cols())
+        {
+            _points.conservativeResize(_dim, std::max(Eigen::Index(16), 2 * _points.cols()));
+        }
+        _points.col(_size++) = p.getCoefficients();
+    }
+
+    // keep the memory for the next points
+    void clear()
+    {
+        _size = 0;
+    }
+
+    void reserve(unsigned int const& capacity)
+    {
+        if (Eigen::Index(capacity) > _points.cols()) _points.conservativeResize(_dim, capacity);
+    }
+
+    unsigned int size() const
+    {
+        return _size;
+    }
+
+    bool empty() const
+    {
+        return _size == 0;
+    }
+
+    unsigned int dimension() const
+    {
+        return _dim;
+    }
+
+    const_iterator begin() const
+    {
+        return const_iterator(this, 0);
+    }
+
+    const_iterator end() const
+    {
+        return const_iterator(this, _size);
+    }
+
+    // the dim x size() matrix of the points
+    MatrixView matrix() const
+    {
+        return _points.leftCols(_size);
+    }
+
+    // the columns [first, first + num)
+    MatrixView matrix(unsigned int const& first, unsigned int const& num) const
+    {
+        return _points.middleCols(first, num);
+    }
+
+private:
+    MT _points;
+    unsigned int _dim;
+    unsigned int _size;
+};
+
+
+// in[j] = P.is_in(p_j) for the points p_first, ..., p_{first + num - 1}
+template <typename ConvexBody, typename Point>
+void points_in(ConvexBody const& P,
+               PointMatrix<Point> const& points,
+               unsigned int const& first,
+               unsigned int const& num,
+               std::vector<int>& in)
+{
+    in.resize(num);
+    typename PointMatrix<Point>::const_iterator pit(&points, first);
+    for (unsigned int j = 0; j < num; ++j, ++pit) in[j] = P.is_in(*pit);
+}
+
+template <typename Point>
+void points_in(HPolytope<Point> const& P,
+               PointMatrix<Point> const& points,
+               unsigned int const& first,
+               unsigned int const& num,
+               std::vector<int>& in)
+{
+    P.is_in(points.matrix(first, num), in);
+}
+
+template <typename Point>
+void points_in(Ball<Point> const& B,
+               PointMatrix<Point> const& points,
+               unsigned int const& first,
+               unsigned int const& num,
+               std::vector<int>& in)
+{
+    B.is_in(points.matrix(first, num), in);
+}
+
+
+// Visits the points of a list in order and tells whether each one is in a
+// convex body. For a std::list it calls is_in per point; for a PointMatrix
+// it tests the points in blocks of columns with the batch is_in of the
+// body, if any, and it never tests more than one block past the last point
+// visited.
+template <typename ConvexBody, typename PointList>
+class PointsInBody
+{
+public:
+    PointsInBody(ConvexBody const& P, PointList const& points)
+        :   _P(P), _pit(points.begin())
+    {}
+
+    bool next()
+    {
+        return _P.is_in(*_pit++) == -1;
+    }
+
+private:
+    ConvexBody const& _P;
+    typename PointList::const_iterator _pit;
+};
+
+template <typename ConvexBody, typename Point>
+class PointsInBody<ConvexBody, PointMatrix<Point> >
+{
+public:
+    PointsInBody(ConvexBody const& P, PointMatrix<Point> const& points,
+                 unsigned int const& block_size = 256)
+        :   _P(P), _points(points), _block_size(block_size), _first(0), _next(0)
+    {}
+
+    bool next()
+    {
+        if (_next == _in.size())
+        {
+            _first += _in.size();
+            unsigned int num = std::min(_block_size, _points.size() - _first);
+            points_in(_P, _points, _first, num, _in);
+            _next = 0;
+        }
+        return _in[_next++] == -1;
+    }
+
+private:
+    ConvexBody const& _P;
+    PointMatrix<Point> const& _points;
+    unsigned int _block_size;
+    unsigned int _first;
+    unsigned int _next;
+    std::vector<int> _in;
+};
+
+
+#endif // SAMPLERS_POINT_MATRIX_HPP
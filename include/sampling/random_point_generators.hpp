@@ -65,6 +65,78 @@ struct RandomPointGenerator
     }
 };
 
+// Generator for walks that advance many chains at once, e.g. MultiBilliardWalk.
+// The columns of X are the current points of the chains and each one of the
+// rnum iterations stores X.cols() points, one per chain.
+template
+<
+    typename Walk
+>
+struct MultiChainRandomPointGenerator
+{
+    template
+    <
+        typename Polytope,
+        typename MT,
+        typename PointList,
+        typename WalkPolicy,
+        typename RandomNumberGenerator,
+        typename Parameters
+    >
+    static void apply(Polytope& P,
+                      MT &X,   // the starting points
+                      unsigned int const& rnum,
+                      unsigned int const& walk_length,
+                      PointList &randPoints,
+                      WalkPolicy &policy,
+                      RandomNumberGenerator &rng,
+                      Parameters const& parameters)
+    {
+        typedef typename Polytope::PointType Point;
+
+        Walk walk(P, X, rng, parameters);
+        for (unsigned int i=0; i<rnum; ++i)
+        {
+            walk.template apply(P, X, walk_length, rng);
+            for (int j=0; j<X.cols(); ++j)
+            {
+                Point p(X.col(j));
+                policy.apply(randPoints, p);
+            }
+        }
+    }
+
+    template
+    <
+        typename Polytope,
+        typename MT,
+        typename PointList,
+        typename WalkPolicy,
+        typename RandomNumberGenerator
+    >
+    static void apply(Polytope& P,
+                      MT &X,   // the starting points
+                      unsigned int const& rnum,
+                      unsigned int const& walk_length,
+                      PointList &randPoints,
+                      WalkPolicy &policy,
+                      RandomNumberGenerator &rng)
+    {
+        typedef typename Polytope::PointType Point;
+
+        Walk walk(P, X, rng);
+        for (unsigned int i=0; i<rnum; ++i)
+        {
+            walk.template apply(P, X, walk_length, rng);
+            for (int j=0; j<X.cols(); ++j)
+            {
+                Point p(X.col(j));
+                policy.apply(randPoints, p);
+            }
+        }
+    }
+};
+
 template
 <
     typename Walk
@@ -0,0 +1,266 @@
+// VolEsti (volume computation and sampling library)
+
+// Copyright (c) 2012-2020 Vissarion Fisikopoulos
+// Copyright (c) 2018-2020 Apostolos Chalkis
+
+// Licensed under GNU LGPL.3, see LICENCE file
+
+#ifndef SAMPLERS_SAMPLE_FILE_HPP
+#define SAMPLERS_SAMPLE_FILE_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <Eigen/Eigen>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define VOLESTI_SAMPLE_FILE_MMAP
+#endif
+
+
+// The header of a sample file. It is followed by the samples as a column
+// major dim x num_samples matrix of numbers of num_type_size bytes, i.e. one
+// point after the other, starting at byte sizeof(SampleFileHeader).
+struct SampleFileHeader
+{
+    char magic[8];                  // "VOLESTI" and a null byte
+    std::uint32_t version;
+    std::uint32_t num_type_size;    // sizeof(NT)
+    std::uint64_t dimension;
+    std::uint64_t num_samples;
+    std::uint64_t seed;
+    char walk[32];                  // the name of the walk, null terminated
+    char reserved[56];
+
+    static constexpr std::uint32_t current_version = 1;
+
+    SampleFileHeader()
+    {
+        std::memset(this, 0, sizeof(SampleFileHeader));
+        std::memcpy(magic, "VOLESTI", 8);
+        version = current_version;
+    }
+
+    bool valid() const
+    {
+        return std::memcmp(magic, "VOLESTI", 8) == 0 && version == current_version;
+    }
+};
+
+static_assert(sizeof(SampleFileHeader) == 128,
+              "the layout of the sample file header is fixed");
+
+
+// Writes the points of a sampler to a sample file, e.g. through
+// StreamToFileWalkPolicy. The points are gathered in a dim x block_size
+// buffer that is written in one call when it is full, thus the memory does
+// not grow with the number of samples. The header is completed by close.
+template <typename NT>
+class SampleFileWriter
+{
+    typedef Eigen::Matrix<NT, Eigen::Dynamic, Eigen::Dynamic> MT;
+
+public:
+    SampleFileWriter(std::string const& filename,
+                     unsigned int const& dim,
+                     std::uint64_t const& seed = 0,
+                     std::string const& walk = "",
+                     unsigned int const& block_size = 4096)
+        :   _file(filename.c_str(), std::ios::binary | std::ios::trunc)
+        ,   _block(dim, block_size)
+        ,   _num_buffered(0)
+    {
+        if (!_file) throw std::runtime_error("cannot open the sample file " + filename);
+        _header.num_type_size = sizeof(NT);
+        _header.dimension = dim;
+        _header.seed = seed;
+        std::strncpy(_header.walk, walk.c_str(), sizeof(_header.walk) - 1);
+        write_header();
+    }
+
+    ~SampleFileWriter()
+    {
+        if (_file.is_open()) close();
+    }
+
+    SampleFileWriter(SampleFileWriter const&) = delete;
+    SampleFileWriter& operator=(SampleFileWriter const&) = delete;
+
+    template <typename Point>
+    void push_back(Point const& p)
+    {
+        _block.col(_num_buffered++) = p.getCoefficients();
+        if (_num_buffered == _block.cols()) flush();
+    }
+
+    // the samples written so far, buffered ones included
+    std::uint64_t size() const
+    {
+        return _header.num_samples + _num_buffered;
+    }
+
+    unsigned int dimension() const
+    {
+        return _header.dimension;
+    }
+
+    // write the buffered samples and the number of samples to the file
+    void flush()
+    {
+        _file.write(reinterpret_cast<const char*>(_block.data()),
+                    std::streamsize(sizeof(NT)) * _block.rows() * _num_buffered);
+        _header.num_samples += _num_buffered;
+        _num_buffered = 0;
+        write_header();
+        if (!_file) throw std::runtime_error("cannot write the sample file");
+    }
+
+    void close()
+    {
+        flush();
+        _file.close();
+    }
+
+private:
+
+    // rewrite the header in place and return to the end of the samples
+    void write_header()
+    {
+        std::streampos end = _file.tellp();
+        _file.seekp(0);
+        _file.write(reinterpret_cast<const char*>(&_header), sizeof(SampleFileHeader));
+        if (end > std::streampos(sizeof(SampleFileHeader))) _file.seekp(end);
+        _file.flush();
+    }
+
+    std::ofstream _file;
+    SampleFileHeader _header;
+    MT _block;
+    unsigned int _num_buffered;
+};
+
+
+// Read-only view of a sample file. The file is memory mapped on POSIX
+// systems, so samples() maps the whole dim x num_samples matrix while the
+// pages are loaded on demand; on other systems the samples are read.
+// The map can be passed to the diagnostics, e.g. multivariate_psrf.
+template <typename NT>
+class SampleFileReader
+{
+    typedef Eigen::Matrix<NT, Eigen::Dynamic, Eigen::Dynamic> MT;
+
+public:
+    typedef Eigen::Map<const MT> SamplesMap;
+
+    explicit SampleFileReader(std::string const& filename)
+        :   _data(nullptr), _length(0)
+    {
+#ifdef VOLESTI_SAMPLE_FILE_MMAP
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0) throw std::runtime_error("cannot open the sample file " + filename);
+        struct stat st;
+        if (::fstat(fd, &st) != 0 || std::size_t(st.st_size) < sizeof(SampleFileHeader))
+        {
+            ::close(fd);
+            throw std::runtime_error("not a sample file " + filename);
+        }
+        _length = st.st_size;
+        void* data = ::mmap(nullptr, _length, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (data == MAP_FAILED) throw std::runtime_error("cannot map the sample file " + filename);
+        _data = static_cast<const char*>(data);
+#else
+        std::ifstream file(filename.c_str(), std::ios::binary);
+        if (!file) throw std::runtime_error("cannot open the sample file " + filename);
+        _buffer.assign(std::istreambuf_iterator<char>(file),
+                       std::istreambuf_iterator<char>());
+        _length = _buffer.size();
+        _data = _buffer.data();
+#endif
+        if (_length < sizeof(SampleFileHeader))
+        {
+            release();
+            throw std::runtime_error("not a sample file " + filename);
+        }
+        std::memcpy(&_header, _data, sizeof(SampleFileHeader));
+        if (!_header.valid() || _header.num_type_size != sizeof(NT)
+            || _length < sizeof(SampleFileHeader)
+                         + sizeof(NT) * _header.dimension * _header.num_samples)
+        {
+            release();
+            throw std::runtime_error("not a sample file of this number type " + filename);
+        }
+    }
+
+    ~SampleFileReader()
+    {
+        release();
+    }
+
+    SampleFileReader(SampleFileReader const&) = delete;
+    SampleFileReader& operator=(SampleFileReader const&) = delete;
+
+    SampleFileHeader const& header() const
+    {
+        return _header;
+    }
+
+    unsigned int dimension() const
+    {
+        return _header.dimension;
+    }
+
+    std::uint64_t num_samples() const
+    {
+        return _header.num_samples;
+    }
+
+    std::string walk() const
+    {
+        return std::string(_header.walk);
+    }
+
+    // the dim x num_samples matrix of the samples
+    SamplesMap samples() const
+    {
+        return SamplesMap(reinterpret_cast<const NT*>(_data + sizeof(SampleFileHeader)),
+                          _header.dimension, _header.num_samples);
+    }
+
+    // the columns [first, first + num) of the samples
+    SamplesMap samples(std::uint64_t const& first, std::uint64_t const& num) const
+    {
+        return SamplesMap(reinterpret_cast<const NT*>(_data + sizeof(SampleFileHeader))
+                          + first * _header.dimension,
+                          _header.dimension, num);
+    }
+
+private:
+
+    void release()
+    {
+#ifdef VOLESTI_SAMPLE_FILE_MMAP
+        if (_data != nullptr) ::munmap(const_cast<char*>(_data), _length);
+#endif
+        _data = nullptr;
+    }
+
+    SampleFileHeader _header;
+    const char* _data;
+    std::size_t _length;
+#ifndef VOLESTI_SAMPLE_FILE_MMAP
+    std::vector<char> _buffer;
+#endif
+};
+
+
+#endif // SAMPLERS_SAMPLE_FILE_HPP
@@ -22,6 +22,11 @@
 #ifndef SAMPLE_ONLY_H
 #define SAMPLE_ONLY_H
 
+#include <list>
+#include <vector>
+
+#include "misc/parallel_tasks.hpp"
+
 template <typename WalkTypePolicy,
         typename PointList,
         typename Polytope,
@@ -58,6 +63,46 @@ void uniform_sampling(PointList &randPoints,
 
 }
 
+// As uniform_sampling, but the points are streamed to writer (e.g. a
+// SampleFileWriter) instead of a point list, so the memory does not grow
+// with rnum
+template <typename WalkTypePolicy,
+        typename SampleWriter,
+        typename Polytope,
+        typename RandomNumberGenerator,
+        typename Point
+        >
+void uniform_sampling_to_file(SampleWriter &writer,
+                              Polytope &P,
+                              RandomNumberGenerator &rng,
+                              const unsigned int &walk_len,
+                              const unsigned int &rnum,
+                              const Point &starting_point,
+                              unsigned int const& nburns)
+{
+
+    typedef typename WalkTypePolicy::template Walk
+            <
+                    Polytope,
+                    RandomNumberGenerator
+            > walk;
+
+    PushBackWalkPolicy push_back_policy;
+    StreamToFileWalkPolicy<SampleWriter> stream_policy(writer);
+
+    Point p = starting_point;
+    std::list<Point> burnin_points;
+
+    typedef RandomPointGenerator <walk> RandomPointGenerator;
+    RandomPointGenerator::apply(P, p, nburns, walk_len, burnin_points,
+                                push_back_policy, rng);
+    burnin_points.clear();
+    RandomPointGenerator::apply(P, p, rnum, walk_len, burnin_points,
+                                stream_policy, rng);
+    writer.flush();
+}
+
+
 template <
         typename PointList,
         typename Polytope,
@@ -94,6 +139,119 @@ void uniform_sampling(PointList &randPoints,
 }
 
 
+// Multi-threaded uniform sampling. The rnum points are split between
+// n_threads chains, they run on the threads of pool, each one with its own
+// copy of P and its own random number generator on the stream
+// (seed, chain_id), and stores its points in a private list.
+// The lists are appended to randPoints in chain order, thus for a fixed seed
+// and number of chains the output is identical between runs and it does not
+// depend on the size of the pool.
+template
+<
+        typename WalkTypePolicy,
+        typename RandomNumberGenerator,
+        typename PointList,
+        typename Polytope,
+        typename Point
+>
+void uniform_sampling_parallel(PointList &randPoints,
+                               Polytope &P,
+                               const unsigned int &walk_len,
+                               const unsigned int &rnum,
+                               const Point &starting_point,
+                               unsigned int const& nburns,
+                               unsigned int const& n_threads,
+                               unsigned int const& seed,
+                               ThreadPool& pool = default_thread_pool())
+{
+    typedef typename WalkTypePolicy::template Walk
+            <
+                    Polytope,
+                    RandomNumberGenerator
+            > walk;
+    typedef RandomPointGenerator<walk> RandomPointGenerator;
+
+    std::vector<PointList> thread_points(n_threads);
+
+    run_parallel_for(n_threads, n_threads, [&](unsigned int t)
+    {
+        unsigned int t_rnum = rnum / n_threads + ((t < rnum % n_threads) ? 1 : 0);
+
+        // every chain works on its own copy of P since the oracles
+        // of some convex bodies (e.g. V-polytopes) use internal buffers
+        Polytope P_t(P);
+        RandomNumberGenerator rng(P.dimension());
+        rng.set_stream(seed, t);
+        PushBackWalkPolicy push_back_policy;
+        Point p = starting_point;
+
+        RandomPointGenerator::apply(P_t, p, nburns, walk_len, thread_points[t],
+                                    push_back_policy, rng);
+        thread_points[t].clear();
+        RandomPointGenerator::apply(P_t, p, t_rnum, walk_len, thread_points[t],
+                                    push_back_policy, rng);
+    }, pool);
+
+    for (auto& points : thread_points)
+    {
+        randPoints.insert(randPoints.end(), points.begin(), points.end());
+    }
+}
+
+template
+<
+        typename RandomNumberGenerator,
+        typename PointList,
+        typename Polytope,
+        typename WalkTypePolicy,
+        typename Point
+>
+void uniform_sampling_parallel(PointList &randPoints,
+                               Polytope &P,
+                               WalkTypePolicy &WalkType,
+                               const unsigned int &walk_len,
+                               const unsigned int &rnum,
+                               const Point &starting_point,
+                               unsigned int const& nburns,
+                               unsigned int const& n_threads,
+                               unsigned int const& seed,
+                               ThreadPool& pool = default_thread_pool())
+{
+    typedef typename WalkTypePolicy::template Walk
+            <
+                    Polytope,
+                    RandomNumberGenerator
+            > walk;
+    typedef RandomPointGenerator<walk> RandomPointGenerator;
+
+    std::vector<PointList> thread_points(n_threads);
+
+    run_parallel_for(n_threads, n_threads, [&](unsigned int t)
+    {
+        unsigned int t_rnum = rnum / n_threads + ((t < rnum % n_threads) ? 1 : 0);
+
+        // every chain works on its own copy of P since the oracles
+        // of some convex bodies (e.g. V-polytopes) use internal buffers
+        Polytope P_t(P);
+        RandomNumberGenerator rng(P.dimension());
+        rng.set_stream(seed, t);
+        PushBackWalkPolicy push_back_policy;
+        Point p = starting_point;
+
+        RandomPointGenerator::apply(P_t, p, nburns, walk_len, thread_points[t],
+                                    push_back_policy, rng, WalkType.param);
+        thread_points[t].clear();
+        RandomPointGenerator::apply(P_t, p, t_rnum, walk_len, thread_points[t],
+                                    push_back_policy, rng, WalkType.param);
+    }, pool);
+
+    for (auto& points : thread_points)
+    {
+        randPoints.insert(randPoints.end(), points.begin(), points.end());
+    }
+}
+
+
 template
 <
         typename WalkTypePolicy,
@@ -174,6 +332,48 @@ void gaussian_sampling(PointList &randPoints,
 }
 
 
+// As gaussian_sampling, but the points are streamed to writer
+template
+<
+        typename WalkTypePolicy,
+        typename SampleWriter,
+        typename Polytope,
+        typename RandomNumberGenerator,
+        typename NT,
+        typename Point
+>
+void gaussian_sampling_to_file(SampleWriter &writer,
+                               Polytope &P,
+                               RandomNumberGenerator &rng,
+                               const unsigned int &walk_len,
+                               const unsigned int &rnum,
+                               const NT &a,
+                               const Point &starting_point,
+                               unsigned int const& nburns)
+{
+
+    typedef typename WalkTypePolicy::template Walk
+            <
+                    Polytope,
+                    RandomNumberGenerator
+            > walk;
+
+    PushBackWalkPolicy push_back_policy;
+    StreamToFileWalkPolicy<SampleWriter> stream_policy(writer);
+
+    Point p = starting_point;
+    std::list<Point> burnin_points;
+
+    typedef GaussianRandomPointGenerator <walk> RandomPointGenerator;
+    RandomPointGenerator::apply(P, p, a, nburns, walk_len, burnin_points,
+                                push_back_policy, rng);
+    burnin_points.clear();
+    RandomPointGenerator::apply(P, p, a, rnum, walk_len, burnin_points,
+                                stream_policy, rng);
+    writer.flush();
+}
+
+
 template <
         typename PointList,
         typename Polytope,
@@ -11,6 +11,9 @@
 #ifndef SAMPLERS_SPHERE_HPP
 #define SAMPLERS_SPHERE_HPP
 
+#include <algorithm>
+#include <Eigen/Eigen>
+
 
 template <typename Point>
 struct GetDirection
@@ -22,8 +25,19 @@ struct GetDirection
                               RandomNumberGenerator &rng,
                               bool normalize=true)
     {
-        NT normal = NT(0);
         Point p(dim);
+        apply(dim, rng, p, normalize);
+        return p;
+    }
+
+    // as above but write the direction to p, which has to be of dimension dim
+    template <typename RandomNumberGenerator>
+    inline static void apply(unsigned int const& dim,
+                             RandomNumberGenerator &rng,
+                             Point &p,
+                             bool normalize=true)
+    {
+        NT normal = NT(0);
         NT* data = p.pointerToData();
 
         for (unsigned int i=0; i<dim; ++i)
@@ -35,9 +49,59 @@ struct GetDirection
 
         normal = NT(1)/std::sqrt(normal);
         if (normalize) p *= normal;
+    }
 
-        return p;
+    // fill the columns of the dim x num_directions matrix directions with
+    // random unit vectors, drawing all the normal numbers in one call
+    template <typename RandomNumberGenerator, typename MT>
+    inline static void apply(unsigned int const& dim,
+                             unsigned int const& num_directions,
+                             RandomNumberGenerator &rng,
+                             MT &directions)
+    {
+        directions.resize(dim, num_directions);
+        rng.sample_ndist(directions.data(), dim * num_directions);
+        for (unsigned int j = 0; j < num_directions; ++j)
+        {
+            directions.col(j).normalize();
+        }
+    }
+};
+
+// A ring buffer of random unit vectors owned by a chain. It is refilled in
+// bulk by GetDirection when it runs empty, thus a walk step reads its
+// direction instead of calling the random number generator dim times.
+template <typename Point>
+class DirectionBuffer
+{
+    typedef typename Point::FT NT;
+    typedef Eigen::Matrix<NT, Eigen::Dynamic, Eigen::Dynamic> MT;
+
+public:
+    DirectionBuffer(unsigned int const& num_directions = 64)
+        :   _num_directions(num_directions), _next(0)
+    {}
+
+    // write the next direction to v, which has to be of dimension dim
+    template <typename RandomNumberGenerator>
+    inline void next(unsigned int const& dim,
+                     RandomNumberGenerator &rng,
+                     Point &v)
+    {
+        if (_next == _directions.cols() || _directions.rows() != dim)
+        {
+            GetDirection<Point>::apply(dim, _num_directions, rng, _directions);
+            _next = 0;
+        }
+        const NT* direction = _directions.data() + _next * dim;
+        std::copy(direction, direction + dim, v.pointerToData());
+        _next++;
     }
+
+private:
+    MT _directions;
+    unsigned int _num_directions;
+    int _next;
 };
 
 template <typename Point>
@@ -48,11 +112,22 @@ struct GetPointInDsphere
                               NT const& radius,
                               RandomNumberGenerator &rng)
     {
-        Point p = GetDirection<Point>::apply(dim, rng);
+        Point p(dim);
+        apply(dim, radius, rng, p);
+        return p;
+    }
+
+    // as above but write the point to p, which has to be of dimension dim
+    template <typename NT, typename RandomNumberGenerator>
+    inline static void apply(unsigned int const& dim,
+                             NT const& radius,
+                             RandomNumberGenerator &rng,
+                             Point &p)
+    {
+        GetDirection<Point>::apply(dim, rng, p);
         NT U = rng.sample_urdist();
         U = std::pow(U, NT(1)/(NT(dim)));
         p *= radius * U;
-        return p;
     }
 };
 
@@ -18,6 +18,26 @@ struct PushBackWalkPolicy
     }
 };
 
+// Pass the points to a writer, e.g. a SampleFileWriter, instead of storing
+// them in the point list of the generator
+template <typename SampleWriter>
+struct StreamToFileWalkPolicy
+{
+    StreamToFileWalkPolicy(SampleWriter &writer)
+            :   _writer(writer)
+    {}
+
+    template <typename PointList, typename Point>
+    void apply(PointList &,
+               Point &p)
+    {
+        _writer.push_back(p);
+    }
+
+private :
+    SampleWriter &_writer;
+};
+
 template <typename BallPoly>
 struct CountingWalkPolicy
 {
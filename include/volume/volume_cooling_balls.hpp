@@ -10,6 +10,7 @@
 #ifndef VOLUME_COOLING_BALLS_HPP
 #define VOLUME_COOLING_BALLS_HPP
 
+#include <functional>
 #include <boost/math/distributions/students_t.hpp>
 #include <boost/math/special_functions/erf.hpp>
 
@@ -22,6 +23,8 @@
 #endif
 #include "convex_bodies/ballintersectconvex.h"
 #include "sampling/random_point_generators.hpp"
+#include "sampling/point_matrix.hpp"
+#include "misc/parallel_tasks.hpp"
 
 
 ////////////////////////////////////
@@ -74,10 +77,11 @@ bool check_convergence(ConvexBody const& P,
     NT rs;
     NT alpha_check = 0.01;
     size_t countsIn = 0;
+    PointsInBody<ConvexBody, PointList> points_in_body(P, randPoints);
 
-    for (auto pit=randPoints.begin(); pit!=randPoints.end(); ++pit, i++)
+    for (std::size_t j = 0; j < randPoints.size(); ++j, i++)
     {
-        if (P.is_in(*pit)==-1) countsIn++;
+        if (points_in_body.next()) countsIn++;
         if (i % m == 0)
         {
             ratios.push_back(NT(countsIn)/m);
@@ -134,7 +138,7 @@ bool get_first_ball(Polytope const& P,
     bool bisection_int = false;
     bool pass = false;
     bool too_few = false;
-    std::list <Point> randPoints;
+    PointMatrix<Point> randPoints(n, 1200);
     NT rmax = parameters.rmax;
     NT sqrt_n = std::sqrt(NT(n));
     NT radius1 = radius_input;
@@ -292,7 +296,7 @@ bool get_sequence_of_polytopeballs(Polytope& P,
     int n = P.dimension();
     NT ratio;
     NT ratio0;
-    std::list<Point> randPoints;
+    PointMatrix<Point> randPoints(n, Ntot);
     ball B0;
     Point q(n);
 
@@ -704,14 +708,15 @@ std::pair<double, double> volume_cooling_balls(Polytope const& Pin,
                                        RandomNumberGenerator &rng,
                                        double const& error = 0.1,
                                        unsigned int const& walk_length = 1,
-                                       unsigned int const& win_len = 300)
+                                       unsigned int const& win_len = 300,
+                                       unsigned int const& n_threads = 1,
+                                       ThreadPool& pool = default_thread_pool())
 {
     typedef typename Polytope::PointType Point;
     typedef typename Point::FT NT;
     typedef Ball<Point> BallType;
     typedef BallIntersectPolytope <Polytope, BallType> PolyBall;
     typedef typename Polytope::VT VT;
-    typedef std::list <Point> PointList;
 
     typedef typename WalkTypePolicy::template Walk
                                               <
@@ -758,14 +763,22 @@ std::pair<double, double> volume_cooling_balls(Polytope const& Pin,
     NT er0 = error / (2.0 * std::sqrt(NT(mm)));
     NT er1 = (error * std::sqrt(4.0 * NT(mm) - 1)) / (2.0 * std::sqrt(NT(mm)));
 
-    vol += (parameters.window2) ?
+    // Once the sequence of balls is fixed the ratios are independent, each
+    // one is estimated by its own function of the random number generator
+    std::vector<std::function<NT(RandomNumberGenerator&)>> log_ratio_estimators;
+
+    log_ratio_estimators.push_back([&](RandomNumberGenerator &rng_i)
+    {
+        auto P_i(P);
+        return (parameters.window2) ?
                 std::log(estimate_ratio<Point>(*(BallSet.end() - 1),
-                                               P, *(ratios.end() - 1),
-                                               er0, parameters.win_len, 1200, rng))
+                                               P_i, *(ratios.end() - 1),
+                                               er0, parameters.win_len, 1200, rng_i))
               : std::log(estimate_ratio_interval<Point>(*(BallSet.end() - 1),
-                                                        P, *(ratios.end() - 1),
+                                                        P_i, *(ratios.end() - 1),
                                                         er0, parameters.win_len, 1200,
-                                                        prob, rng));
+                                                        prob, rng_i));
+    });
 
     auto balliter = BallSet.begin();
     auto ratioiter = ratios.begin();
@@ -774,49 +787,82 @@ std::pair<double, double> volume_cooling_balls(Polytope const& Pin,
 
     if (*ratioiter != 1)
     {
-        vol += (!parameters.window2) ?
-               std::log(NT(1) / estimate_ratio_interval
-                    <WalkType, Point>(P,
-                                      *balliter,
-                                      *ratioiter,
-                                      er1,
-                                      parameters.win_len,
-                                      N_times_nu,
-                                      prob,
-                                      walk_length,
-                                      rng))
-            : std::log(NT(1) / estimate_ratio
-                    <WalkType, Point>(P,
-                                      *balliter,
-                                      *ratioiter,
-                                      er1,
-                                      parameters.win_len,
-                                      N_times_nu,
-                                      walk_length,
-                                      rng));
+        log_ratio_estimators.push_back([&, balliter, ratioiter](RandomNumberGenerator &rng_i)
+        {
+            auto P_i(P);
+            return (!parameters.window2) ?
+                   std::log(NT(1) / estimate_ratio_interval
+                        <WalkType, Point>(P_i,
+                                          *balliter,
+                                          *ratioiter,
+                                          er1,
+                                          parameters.win_len,
+                                          N_times_nu,
+                                          prob,
+                                          walk_length,
+                                          rng_i))
+                : std::log(NT(1) / estimate_ratio
+                        <WalkType, Point>(P_i,
+                                          *balliter,
+                                          *ratioiter,
+                                          er1,
+                                          parameters.win_len,
+                                          N_times_nu,
+                                          walk_length,
+                                          rng_i));
+        });
     }
 
     for ( ; balliter < BallSet.end() - 1; ++balliter, ++ratioiter)
     {
-        PolyBall Pb(P, *balliter);
-        vol += (!parameters.window2) ?
-                    std::log(NT(1) / estimate_ratio_interval
-                                <WalkType, Point>(Pb,
-                                                  *(balliter + 1),
-                                                  *(ratioiter + 1),
-                                                  er1, parameters.win_len,
-                                                  N_times_nu,
-                                                  prob, walk_length,
-                                                  rng))
-                  : std::log(NT(1) / estimate_ratio
-                                <WalkType, Point>(Pb,
-                                                  *balliter,
-                                                  *ratioiter,
-                                                  er1,
-                                                  parameters.win_len,
-                                                  N_times_nu,
-                                                  walk_length,
-                                                  rng));
+        log_ratio_estimators.push_back([&, balliter, ratioiter](RandomNumberGenerator &rng_i)
+        {
+            PolyBall Pb(P, *balliter);
+            return (!parameters.window2) ?
+                        std::log(NT(1) / estimate_ratio_interval
+                                    <WalkType, Point>(Pb,
+                                                      *(balliter + 1),
+                                                      *(ratioiter + 1),
+                                                      er1, parameters.win_len,
+                                                      N_times_nu,
+                                                      prob, walk_length,
+                                                      rng_i))
+                      : std::log(NT(1) / estimate_ratio
+                                    <WalkType, Point>(Pb,
+                                                      *balliter,
+                                                      *ratioiter,
+                                                      er1,
+                                                      parameters.win_len,
+                                                      N_times_nu,
+                                                      walk_length,
+                                                      rng_i));
+        });
+    }
+
+    std::vector<NT> log_ratios(log_ratio_estimators.size());
+
+    if (n_threads <= 1)
+    {
+        for (std::size_t i = 0; i < log_ratio_estimators.size(); ++i)
+        {
+            log_ratios[i] = log_ratio_estimators[i](rng);
+        }
+    } else
+    {
+        // every ratio is estimated by an independent chain with its own
+        // random number generator, derived from rng
+        run_parallel_tasks<RandomNumberGenerator>(log_ratio_estimators.size(),
+                                                  n_threads, n,
+                                                  draw_stream_seed(rng),
+                                                  [&](unsigned int i, RandomNumberGenerator &rng_i)
+        {
+            log_ratios[i] = log_ratio_estimators[i](rng_i);
+        }, pool);
+    }
+
+    for (auto log_ratio : log_ratios)
+    {
+        vol += log_ratio;
     }
 
     return std::pair<NT, NT> (vol, std::exp(vol));
@@ -833,10 +879,13 @@ template
 >
 std::pair<double, double> volume_cooling_balls(Polytope const& Pin,
                                                double const& error = 0.1,
-                                               unsigned int const& walk_length = 1)
+                                               unsigned int const& walk_length = 1,
+                                               unsigned int const& n_threads = 1,
+                                               ThreadPool& pool = default_thread_pool())
 {
     RandomNumberGenerator rng(Pin.dimension());
-    return volume_cooling_balls<WalkTypePolicy>(Pin, rng, error, walk_length);
+    return volume_cooling_balls<WalkTypePolicy>(Pin, rng, error, walk_length,
+                                                300, n_threads, pool);
 }
 
 
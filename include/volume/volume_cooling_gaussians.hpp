@@ -23,6 +23,7 @@
 #include "random_walks/gaussian_ball_walk.hpp"
 #include "random_walks/gaussian_cdhr_walk.hpp"
 #include "sampling/random_point_generators.hpp"
+#include "misc/parallel_tasks.hpp"
 
 
 /////////////////// Helpers for random walks
@@ -284,6 +285,92 @@ void compute_annealing_schedule(Polytope const& P,
     }
 }
 
+// Estimate the ratio of the integrals of the gaussians with parameters
+// a_next and a over P, using a sliding window of W values as convergence test.
+// The chain starts from p, which is updated to the last point of the chain
+template
+<
+    typename WalkType,
+    typename Polytope,
+    typename Point,
+    typename NT,
+    typename RandomNumberGenerator
+>
+NT estimate_gaussian_ratio(Polytope& P,
+                           Point &p,
+                           NT const& a,
+                           NT const& a_next,
+                           unsigned int const& W,
+                           NT const& curr_eps,
+                           NT const& radius,
+                           unsigned int const& walk_length,
+                           NT& its,
+                           RandomNumberGenerator& rng)
+{
+    typedef typename std::vector<NT>::iterator viterator;
+
+    //initialize convergence test
+    bool done = false;
+    NT fn = NT(0);
+    NT min_val = std::numeric_limits<NT>::min();
+    NT max_val = std::numeric_limits<NT>::max();
+    unsigned int min_index = W-1;
+    unsigned int max_index = W-1;
+    unsigned int index = 0;
+    unsigned int min_steps = 0;
+    unsigned int n = P.dimension();
+    std::vector<NT> last_W(W, NT(0));
+    viterator minmaxIt;
+
+    // Set the radius for the ball walk
+    WalkType walk(P, p, a, rng);
+
+    update_delta<WalkType>
+            ::apply(walk, 4.0 * radius
+                     / std::sqrt(std::max(NT(1.0), a) * NT(n)));
+
+    while (!done || its<min_steps)
+    {
+        walk.template apply(P, p, a, walk_length, rng);
+
+        its = its + 1.0;
+        fn = fn + eval_exp(p, a_next) / eval_exp(p, a);
+        NT val = fn / its;
+
+        last_W[index] = val;
+        if (val <= min_val)
+        {
+            min_val = val;
+            min_index = index;
+        } else if (min_index == index)
+        {
+            minmaxIt = std::min_element(last_W.begin(), last_W.end());
+            min_val = *minmaxIt;
+            min_index = std::distance(last_W.begin(), minmaxIt);
+        }
+
+        if (val >= max_val)
+        {
+            max_val = val;
+            max_index = index;
+        } else if (max_index == index)
+        {
+            minmaxIt = std::max_element(last_W.begin(), last_W.end());
+            max_val = *minmaxIt;
+            max_index = std::distance(last_W.begin(), minmaxIt);
+        }
+
+        if ( (max_val-min_val)/max_val <= curr_eps/2.0 )
+        {
+            done=true;
+        }
+
+        index = index%W + 1;
+        if (index == W) index = 0;
+    }
+    return fn / its;
+}
+
 template <typename NT>
 struct gaussian_annealing_parameters
 {
@@ -312,7 +399,9 @@ template
 double volume_cooling_gaussians(Polytope const& Pin,
                                 RandomNumberGenerator& rng,
                                 double const& error = 0.1,
-                                unsigned int const& walk_length = 1)
+                                unsigned int const& walk_length = 1,
+                                unsigned int const& n_threads = 1,
+                                ThreadPool& pool = default_thread_pool())
 {
     typedef typename Polytope::PointType Point;
     typedef typename Point::FT NT;
@@ -374,92 +463,55 @@ double volume_cooling_gaussians(Polytope const& Pin,
     // Initialization for the approximation of the ratios
     unsigned int W = parameters.W;
     unsigned int mm = a_vals.size()-1;
-    std::vector<NT> last_W2(W,0);
-    std::vector<NT> fn(mm,0);
+    std::vector<NT> ratios(mm,0);
     std::vector<NT> its(mm,0);
-    VT lamdas;
-    lamdas.setZero(m);
+    NT curr_eps = error/std::sqrt((NT(mm)));
     NT vol = std::pow(M_PI/a_vals[0], (NT(n))/2.0);
-    Point p(n); // The origin is the Chebychev center of the Polytope
-    unsigned int i=0;
-
-    typedef typename std::vector<NT>::iterator viterator;
-    viterator itsIt = its.begin();
-    viterator avalsIt = a_vals.begin();
-    viterator minmaxIt;
 
 #ifdef VOLESTI_DEBUG
     std::cout<<"volume of the first gaussian = "<<vol<<"\n"<<std::endl;
     std::cout<<"computing ratios..\n"<<std::endl;
 #endif
 
-    //iterate over the number of ratios
-    for (viterator fnIt = fn.begin();
-         fnIt != fn.end();
-         fnIt++, itsIt++, avalsIt++, i++)
+    if (n_threads <= 1)
     {
-        //initialize convergence test
-        bool done = false;
-        NT curr_eps = error/std::sqrt((NT(mm)));
-        NT min_val = std::numeric_limits<NT>::min();
-        NT max_val = std::numeric_limits<NT>::max();
-        unsigned int min_index = W-1;
-        unsigned int max_index = W-1;
-        unsigned int index = 0;
-        unsigned int min_steps = 0;
-        std::vector<NT> last_W = last_W2;
-
-        // Set the radius for the ball walk
-        WalkType walk(P, p, *avalsIt, rng);
-
-        update_delta<WalkType>
-                ::apply(walk, 4.0 * radius
-                         / std::sqrt(std::max(NT(1.0), *avalsIt) * NT(n)));
-
-        while (!done || (*itsIt)<min_steps)
+        // a single chain visits all the gaussians, each one starting
+        // from the last point of the previous one
+        Point p(n); // The origin is the Chebychev center of the Polytope
+        for (unsigned int i = 0; i < mm; i++)
         {
-            walk.template apply(P, p, *avalsIt, walk_length, rng);
-
-            *itsIt = *itsIt + 1.0;
-            *fnIt = *fnIt + eval_exp(p,*(avalsIt+1)) / eval_exp(p,*avalsIt);
-            NT val = (*fnIt) / (*itsIt);
-
-            last_W[index] = val;
-            if (val <= min_val)
-            {
-                min_val = val;
-                min_index = index;
-            } else if (min_index == index)
-            {
-                minmaxIt = std::min_element(last_W.begin(), last_W.end());
-                min_val = *minmaxIt;
-                min_index = std::distance(last_W.begin(), minmaxIt);
-            }
-
-            if (val >= max_val)
-            {
-                max_val = val;
-                max_index = index;
-            } else if (max_index == index)
-            {
-                minmaxIt = std::max_element(last_W.begin(), last_W.end());
-                max_val = *minmaxIt;
-                max_index = std::distance(last_W.begin(), minmaxIt);
-            }
-
-            if ( (max_val-min_val)/max_val <= curr_eps/2.0 )
-            {
-                done=true;
-            }
-
-            index = index%W + 1;
-            if (index == W) index = 0;
+            ratios[i] = estimate_gaussian_ratio<WalkType>(P, p, a_vals[i],
+                                                          a_vals[i+1], W,
+                                                          curr_eps, radius,
+                                                          walk_length, its[i],
+                                                          rng);
         }
+    } else
+    {
+        // once the schedule is known the ratios are independent; each one
+        // is estimated by its own chain, starting from the Chebychev center,
+        // with its own copy of P and random number generator
+        run_parallel_tasks<RandomNumberGenerator>(mm, n_threads, n,
+                                                  draw_stream_seed(rng),
+                                                  [&](unsigned int i, RandomNumberGenerator &rng_i)
+        {
+            auto P_i(P);
+            Point p(n);
+            ratios[i] = estimate_gaussian_ratio<WalkType>(P_i, p, a_vals[i],
+                                                          a_vals[i+1], W,
+                                                          curr_eps, radius,
+                                                          walk_length, its[i],
+                                                          rng_i);
+        }, pool);
+    }
+
+    for (unsigned int i = 0; i < mm; i++)
+    {
 #ifdef VOLESTI_DEBUG
-        std::cout << "ratio " << i << " = " << (*fnIt) / (*itsIt)
-                  << " N_" << i << " = " << *itsIt << std::endl;
+        std::cout << "ratio " << i << " = " << ratios[i]
+                  << " N_" << i << " = " << its[i] << std::endl;
 #endif
-        vol *= ((*fnIt) / (*itsIt));
+        vol *= ratios[i];
     }
 
 #ifdef VOLESTI_DEBUG
@@ -483,10 +535,13 @@ template
 >
 double volume_cooling_gaussians(Polytope const& Pin,
                                  double const& error = 0.1,
-                                 unsigned int const& walk_length = 1)
+                                 unsigned int const& walk_length = 1,
+                                 unsigned int const& n_threads = 1,
+                                 ThreadPool& pool = default_thread_pool())
 {
     RandomNumberGenerator rng(Pin.dimension());
-    return volume_cooling_gaussians<WalkTypePolicy>(Pin, rng, error, walk_length);
+    return volume_cooling_gaussians<WalkTypePolicy>(Pin, rng, error, walk_length,
+                                                    n_threads, pool);
 }
 
 
@@ -35,6 +35,7 @@
 #include "random_walks/uniform_cdhr_walk.hpp"
 #include "sampling/random_point_generators.hpp"
 #include "volume/sampling_policies.hpp"
+#include "misc/parallel_tasks.hpp"
 
 
 ////////////////////////////// Algorithms
@@ -53,7 +54,8 @@ double volume_sequence_of_balls(Polytope const& Pin,
                                 RandomNumberGenerator &rng,
                                 double const& error = 1.0,
                                 unsigned int const& walk_length = 1,
-                                unsigned int const& n_threads = 1)
+                                unsigned int const& n_threads = 1,
+                                ThreadPool& pool = default_thread_pool())
 {
     typedef typename Polytope::PointType Point;
     typedef typename Polytope::VT VT;
@@ -86,75 +88,105 @@ double volume_sequence_of_balls(Polytope const& Pin,
     P.shift(c.getCoefficients());
     c = Point(n);
 
-    rnum = rnum/n_threads;
     NT vol = NT(0);
 
-    // Perform the procedure for a number of threads and then take the average
-    for (auto t=0u; t<n_threads; t++)
-    {
-        // Generate the first random point in P
-        // Perform random walk on random point in the Chebychev ball
+    // Generate the first random point in P
+    // Perform random walk on random point in the Chebychev ball
 #ifdef VOLESTI_DEBUG
-        std::cout<<"\nGenerate the first random point in P"<<std::endl;
+    std::cout<<"\nGenerate the first random point in P"<<std::endl;
 #endif
-        Point p = GetPointInDsphere<Point>::apply(P.dimension(), radius, rng);
-        std::list<Point> randPoints; //ds for storing rand points
+    Point p = GetPointInDsphere<Point>::apply(P.dimension(), radius, rng);
+    std::list<Point> randPoints; //ds for storing rand points
 
-        PushBackWalkPolicy push_back_policy;
-        RandomPointGenerator::apply(P, p, 1, 50*n, randPoints, push_back_policy, rng);
+    PushBackWalkPolicy push_back_policy;
+    RandomPointGenerator::apply(P, p, 1, 50*n, randPoints, push_back_policy, rng);
 
 #ifdef VOLESTI_DEBUG
-        double tstart2 = (double)clock()/(double)CLOCKS_PER_SEC;
-        std::cout<<"\nCompute "<<rnum<<" random points in P"<<std::endl;
+    double tstart2 = (double)clock()/(double)CLOCKS_PER_SEC;
+    std::cout<<"\nCompute "<<rnum<<" random points in P"<<std::endl;
 #endif
-        RandomPointGenerator::apply(P, p, rnum-1, walk_length, randPoints,
-                                    push_back_policy, rng);
+    RandomPointGenerator::apply(P, p, rnum-1, walk_length, randPoints,
+                                push_back_policy, rng);
 
 #ifdef VOLESTI_DEBUG
-        double tstop2 = (double)clock()/(double)CLOCKS_PER_SEC;
-        std::cout << "First random points construction time = "
-                  << tstop2 - tstart2 << std::endl;
+    double tstop2 = (double)clock()/(double)CLOCKS_PER_SEC;
+    std::cout << "First random points construction time = "
+              << tstop2 - tstart2 << std::endl;
 #endif
 
-        // Construct the sequence of balls
-        // a. compute the radius of the largest ball
-        NT current_dist, max_dist=NT(0);
-        for (auto pit=randPoints.begin(); pit!=randPoints.end(); ++pit)
+    // Construct the sequence of balls
+    // a. compute the radius of the largest ball
+    NT current_dist, max_dist=NT(0);
+    for (auto pit=randPoints.begin(); pit!=randPoints.end(); ++pit)
+    {
+        current_dist = (*pit).squared_length();
+        if (current_dist > max_dist)
         {
-            current_dist = (*pit).squared_length();
-            if (current_dist > max_dist)
-            {
-                max_dist=current_dist;
-            }
+            max_dist=current_dist;
         }
-        max_dist = std::sqrt(max_dist);
+    }
+    max_dist = std::sqrt(max_dist);
 #ifdef VOLESTI_DEBUG
-        std::cout<<"\nFurthest distance from Chebychev point= "<<max_dist
-                <<std::endl;
-        std::cout<<"\nConstructing the sequence of balls"<<std::endl;
-        std::cout<<"---------"<<std::endl;
+    std::cout<<"\nFurthest distance from Chebychev point= "<<max_dist
+            <<std::endl;
+    std::cout<<"\nConstructing the sequence of balls"<<std::endl;
+    std::cout<<"---------"<<std::endl;
 #endif
 
-        //
-        // b. Number of balls
-        int nb1 = n * (std::log(radius)/std::log(2.0));
-        int nb2 = std::ceil(n * (std::log(max_dist)/std::log(2.0)));
+    //
+    // b. Number of balls
+    int nb1 = n * (std::log(radius)/std::log(2.0));
+    int nb2 = std::ceil(n * (std::log(max_dist)/std::log(2.0)));
 
-        std::vector<Ball> balls;
+    std::vector<Ball> balls;
 
-        for (auto i=nb1; i<=nb2; ++i)
+    for (auto i=nb1; i<=nb2; ++i)
+    {
+        if (i == nb1)
         {
-            if (i == nb1)
-            {
-                balls.push_back(Ball(c,radius*radius));
-                vol = (std::pow(M_PI,n/2.0)*(std::pow(balls[0].radius(), n) ) )
-                       / (tgamma(n/2.0+1));
-            } else {
-                balls.push_back(Ball(c,std::pow(std::pow(2.0,NT(i)/NT(n)),2)));
-            }
+            balls.push_back(Ball(c,radius*radius));
+            vol = (std::pow(M_PI,n/2.0)*(std::pow(balls[0].radius(), n) ) )
+                   / (tgamma(n/2.0+1));
+        } else {
+            balls.push_back(Ball(c,std::pow(std::pow(2.0,NT(i)/NT(n)),2)));
         }
-        assert(!balls.empty());
+    }
+    assert(!balls.empty());
 
+    if (n_threads > 1)
+    {
+        // Every pair of consecutive balls is an independent experiment: a
+        // worker samples rnum points from P intersected with the larger ball,
+        // starting from the Chebychev center, and counts the points that fall
+        // into the smaller ball with its own counting policy and random
+        // number generator
+        std::vector<unsigned int> nump_PBSmall(balls.size(), 0);
+
+        run_parallel_tasks<RandomNumberGenerator>(balls.size() - 1, n_threads, n,
+                                                  draw_stream_seed(rng),
+                                                  [&](unsigned int i, RandomNumberGenerator &rng_i)
+        {
+            BallPoly PBLarge(P, balls[i+1]);
+            BallPoly PBSmall(P, balls[i]);
+
+            Point p_gen = c;
+            std::list<Point> points;
+            PushBackWalkPolicy push_back_policy;
+            RandomPointGenerator::apply(PBLarge, p_gen, 1, 50*n, points,
+                                        push_back_policy, rng_i);
+            points.clear();
+
+            CountingWalkPolicy<BallPoly> counting_policy(0, PBSmall);
+            RandomPointGenerator::apply(PBLarge, p_gen, rnum, walk_length,
+                                        points, counting_policy, rng_i);
+            nump_PBSmall[i] = counting_policy.get_nump_PBSmall();
+        }, pool);
+
+        for (auto i=0u; i<balls.size()-1; ++i)
+        {
+            vol *= NT(rnum)/NT(nump_PBSmall[i]);
+        }
+    } else {
         // Estimate Vol(P)
         typename std::vector<Ball>::iterator bit2=balls.end();
         bit2--;
@@ -240,11 +272,12 @@ template
 double volume_sequence_of_balls(Polytope const& Pin,
                                 double const& error = 1.0,
                                 unsigned int const& walk_length = 1,
-                                unsigned int const& n_threads = 1)
+                                unsigned int const& n_threads = 1,
+                                ThreadPool& pool = default_thread_pool())
 {
     RandomNumberGenerator rng(Pin.dimension());
     return volume_sequence_of_balls<WalkTypePolicy>(Pin, rng, error,
-                                                    walk_length, n_threads);
+                                                    walk_length, n_threads, pool);
 }
 
 
@@ -0,0 +1,126 @@
+// VolEsti (volume computation and sampling library)
+
+// Copyright (c) 2012-2020 Vissarion Fisikopoulos
+// Copyright (c) 2018-2020 Apostolos Chalkis
+
+// Licensed under GNU LGPL.3, see LICENCE file
+
+// Benchmark the steps of the random walks and count the heap allocations
+// performed by a walk after its initialization; the allocations of the
+// LP-based oracles of V-polytopes and zonotopes are reported but not checked
+
+// allocation-counting hook: count the heap allocations of Eigen, that
+// calls malloc directly, and the ones performed by operator new
+static unsigned long num_of_allocations = 0;
+
+#define EIGEN_RUNTIME_NO_MALLOC
+#define eigen_assert(x) do { if (!(x)) ++num_of_allocations; } while (false)
+
+#include "Eigen/Eigen"
+#include <chrono>
+#include <cstdlib>
+#include <new>
+#include <boost/random.hpp>
+#include <boost/random/uniform_int.hpp>
+#include <boost/random/normal_distribution.hpp>
+#include <boost/random/uniform_real_distribution.hpp>
+
+#include "cartesian_geom/cartesian_kernel.h"
+#include "random_walks/random_walks.hpp"
+#include "convex_bodies/vpolyintersectvpoly.h"
+#include "generators/known_polytope_generators.h"
+#include "generators/v_polytopes_generators.h"
+#include "generators/z_polytopes_generators.h"
+
+void* operator new(std::size_t size)
+{
+    ++num_of_allocations;
+    void* ptr = std::malloc(size);
+    if (ptr == NULL) throw std::bad_alloc();
+    return ptr;
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+template <typename WalkTypePolicy, typename Polytope>
+bool benchmark_walk(Polytope const& P, std::string const& name,
+                    unsigned int const& num_steps)
+{
+    typedef typename Polytope::PointType Point;
+    typedef typename Point::FT NT;
+    typedef BoostRandomNumberGenerator<boost::mt19937, NT, 3> RNGType;
+    typedef typename WalkTypePolicy::template Walk<Polytope, RNGType> Walk;
+
+    RNGType rng(P.dimension());
+    Point p(P.dimension());
+    Walk walk(P, p, rng);
+    walk.apply(P, p, 1, rng);
+
+    num_of_allocations = 0;
+    Eigen::internal::set_is_malloc_allowed(false);
+    auto start = std::chrono::high_resolution_clock::now();
+    walk.apply(P, p, num_steps, rng);
+    auto stop = std::chrono::high_resolution_clock::now();
+    Eigen::internal::set_is_malloc_allowed(true);
+    unsigned long allocations = num_of_allocations;
+
+    std::cout << name << ": "
+              << std::chrono::duration<double, std::micro>(stop - start).count()
+                 / num_steps
+              << " us/step, " << allocations << " allocations in "
+              << num_steps << " steps" << std::endl;
+    return allocations == 0;
+}
+
+int main()
+{
+    typedef double NT;
+    typedef Cartesian<NT>    Kernel;
+    typedef typename Kernel::Point    Point;
+    typedef HPolytope<Point> Hpolytope;
+    typedef VPolytope<Point> Vpolytope;
+    typedef Zonotope<Point> zonotope;
+    typedef BoostRandomNumberGenerator<boost::mt19937, NT, 3> RNGType;
+    typedef IntersectionOfVpoly<Vpolytope, RNGType> VpIntVp;
+
+    unsigned int num_steps = 100000;
+    bool success = true;
+
+    for (unsigned int d : {10, 50})
+    {
+        std::cout << "--- H-cube" << d << std::endl;
+        Hpolytope P = generate_cube<Hpolytope>(d, false);
+        P.ComputeInnerBall();
+
+        success &= benchmark_walk<BallWalk>(P, "BallWalk", num_steps);
+        success &= benchmark_walk<CDHRWalk>(P, "CDHRWalk", num_steps);
+        success &= benchmark_walk<RDHRWalk>(P, "RDHRWalk", num_steps);
+        success &= benchmark_walk<BilliardWalk>(P, "BilliardWalk", num_steps);
+        success &= benchmark_walk<AcceleratedBilliardWalk>
+                     (P, "AcceleratedBilliardWalk", num_steps);
+    }
+
+    for (unsigned int d : {10, 20})
+    {
+        std::cout << "--- V-polytope" << d << "-" << 10 * d << std::endl;
+        Vpolytope VP = random_vpoly<Vpolytope, boost::mt19937>(d, 10 * d, 127);
+        benchmark_walk<CDHRWalk>(VP, "CDHRWalk", 1000);
+        benchmark_walk<RDHRWalk>(VP, "RDHRWalk", 1000);
+
+        std::cout << "--- zonotope" << d << "-" << 2 * d << std::endl;
+        zonotope ZP = gen_zonotope_uniform<zonotope, boost::mt19937>(d, 2 * d, 127);
+        benchmark_walk<CDHRWalk>(ZP, "CDHRWalk", 1000);
+        benchmark_walk<RDHRWalk>(ZP, "RDHRWalk", 1000);
+
+        std::cout << "--- V-polytope" << d << "-" << 10 * d
+                  << " intersected with V-cross" << d << std::endl;
+        VpIntVp IP(VP, generate_cross<Vpolytope>(d, true));
+        benchmark_walk<CDHRWalk>(IP, "CDHRWalk", 1000);
+        benchmark_walk<RDHRWalk>(IP, "RDHRWalk", 1000);
+    }
+
+    return success ? 0 : 1;
+}
@@ -0,0 +1,267 @@
+// VolEsti (volume computation and sampling library)
+
+// Copyright (c) 2012-2020 Vissarion Fisikopoulos
+// Copyright (c) 2018-2020 Apostolos Chalkis
+
+// Licensed under GNU LGPL.3, see LICENCE file
+
+#include "doctest.h"
+#include <iostream>
+#include "random.hpp"
+#include "random/uniform_int.hpp"
+#include "random/normal_distribution.hpp"
+#include "random/uniform_real_distribution.hpp"
+
+#include "cartesian_geom/cartesian_kernel.h"
+#include "convex_bodies/hpolytope.h"
+#include "convex_bodies/facet_scan.h"
+#include "convex_bodies/sparse_hpolytope.h"
+#include "generators/boost_random_number_generator.hpp"
+#include "sampling/sphere.hpp"
+#include "known_polytope_generators.h"
+
+template <class Polytope>
+void test_batched_line_intersect(Polytope const& P, unsigned int const& K)
+{
+    typedef typename Polytope::PointType Point;
+    typedef typename Point::FT NT;
+    typedef typename Polytope::MT MT;
+    typedef typename Polytope::VT VT;
+    typedef BoostRandomNumberGenerator<boost::mt19937, NT, 3> RNGType;
+
+    unsigned int d = P.dimension();
+    RNGType rng(d);
+    NT tol = 0.00000001;
+
+    MT R(d, K), V(d, K);
+    for (unsigned int i = 0; i < K; ++i) {
+        R.col(i) = GetPointInDsphere<Point>::apply(d, NT(0.5), rng).getCoefficients();
+        V.col(i) = GetDirection<Point>::apply(d, rng).getCoefficients();
+    }
+
+    MT AR, AV;
+    std::pair<VT, VT> res = P.line_intersect(R, V, AR, AV);
+
+    for (unsigned int i = 0; i < K; ++i) {
+        std::pair<NT, NT> single = P.line_intersect(Point(VT(R.col(i))),
+                                                    Point(VT(V.col(i))));
+        CHECK(std::abs(res.first(i) - single.first) < tol);
+        CHECK(std::abs(res.second(i) - single.second) < tol);
+    }
+    CHECK((AR - P.get_mat() * R).norm() < tol);
+    CHECK((AV - P.get_mat() * V).norm() < tol);
+}
+
+template <typename NT>
+void call_test_batched_line_intersect()
+{
+    typedef Cartesian<NT>    Kernel;
+    typedef typename Kernel::Point    Point;
+    typedef HPolytope<Point> Hpolytope;
+
+    std::cout << "--- Testing batched line intersection on H-cube10" << std::endl;
+    Hpolytope P = generate_cube<Hpolytope>(10, false);
+    test_batched_line_intersect(P, 50);
+
+    std::cout << "--- Testing batched line intersection on H-cross5" << std::endl;
+    P = generate_cross<Hpolytope>(5, false);
+    test_batched_line_intersect(P, 50);
+}
+
+TEST_CASE("batched_line_intersect") {
+    call_test_batched_line_intersect<double>();
+}
+
+// the facet scan of the boundary oracles before vectorization
+template <typename NT>
+void reference_facet_scan(NT const* nom, NT const* sub, NT const* denom,
+                          int const& m, NT& min_plus, NT& max_minus, int& facet)
+{
+    min_plus = std::numeric_limits<NT>::max();
+    max_minus = std::numeric_limits<NT>::lowest();
+    facet = -1;
+    for (int i = 0; i < m; i++) {
+        if (denom[i] == NT(0)) continue;
+        NT lamda = (sub == NULL) ? nom[i] / denom[i]
+                                 : (nom[i] - sub[i]) / denom[i];
+        if (lamda < min_plus && lamda > 0) {
+            min_plus = lamda;
+            facet = i;
+        } else if (lamda > max_minus && lamda < 0) max_minus = lamda;
+    }
+}
+
+template <typename NT, typename Kernel>
+void test_facet_scan(Kernel kernel, std::string const& name)
+{
+    typedef Eigen::Matrix<NT, Eigen::Dynamic, 1> VT;
+    typedef BoostRandomNumberGenerator<boost::mt19937, NT, 5> RNGType;
+
+    std::cout << "--- Testing facet scan: " << name << std::endl;
+    RNGType rng(1);
+
+    for (int m : {1, 3, 4, 7, 8, 9, 17, 100, 1001})
+    {
+        for (int trial = 0; trial < 20; trial++)
+        {
+            VT nom(m), sub(m), denom(m);
+            for (int i = 0; i < m; i++)
+            {
+                // rounded values produce zero denominators, zero ratios and ties
+                nom(i) = std::round(4 * rng.sample_ndist());
+                sub(i) = std::round(2 * rng.sample_ndist());
+                denom(i) = std::round(2 * rng.sample_ndist());
+            }
+            if (trial == 0) denom.setZero();
+
+            for (bool with_sub : {false, true})
+            {
+                NT const* s = with_sub ? sub.data() : NULL;
+                NT min_plus, max_minus, ref_min_plus, ref_max_minus;
+                int facet, ref_facet;
+                kernel(nom.data(), s, denom.data(), m, min_plus, max_minus, facet);
+                reference_facet_scan(nom.data(), s, denom.data(), m,
+                                     ref_min_plus, ref_max_minus, ref_facet);
+                CHECK(min_plus == ref_min_plus);
+                CHECK(max_minus == ref_max_minus);
+                CHECK(facet == ref_facet);
+            }
+        }
+    }
+}
+
+template <typename NT>
+void call_test_facet_scan()
+{
+    test_facet_scan<NT>(facet_scan_scalar<NT>, "scalar");
+    test_facet_scan<NT>(FacetScan<NT>::apply, "dispatched");
+}
+
+TEST_CASE("facet_scan") {
+    call_test_facet_scan<double>();
+    call_test_facet_scan<float>();
+#ifdef VOLESTI_FACET_SCAN_X86
+    if (__builtin_cpu_supports("avx2")) {
+        test_facet_scan<double>(facet_scan_avx2, "avx2");
+    }
+    if (__builtin_cpu_supports("avx512f")) {
+        test_facet_scan<double>(facet_scan_avx512, "avx512");
+    }
+#endif
+}
+
+template <typename NT>
+void call_test_sparse_oracles()
+{
+    typedef Cartesian<NT>    Kernel;
+    typedef typename Kernel::Point    Point;
+    typedef HPolytope<Point> Hpolytope;
+    typedef SparseHPolytope<Point> SparseHpolytope;
+    typedef typename Hpolytope::MT MT;
+    typedef typename Hpolytope::VT VT;
+    typedef BoostRandomNumberGenerator<boost::mt19937, NT, 3> RNGType;
+
+    std::cout << "--- Testing sparse oracles on H-cube10 with sparse cuts" << std::endl;
+
+    // the cube [-1,1]^d and random cuts with 3 nonzero entries each
+    unsigned int d = 10, cuts = 20;
+    RNGType rng(d);
+    Hpolytope cube = generate_cube<Hpolytope>(d, false);
+    MT A = MT::Zero(2 * d + cuts, d);
+    VT b(2 * d + cuts);
+    A.topRows(2 * d) = cube.get_mat();
+    b.head(2 * d) = cube.get_vec();
+    for (unsigned int i = 2 * d; i < 2 * d + cuts; ++i) {
+        for (int k = 0; k < 3; ++k) A(i, int(rng.sample_uidist())) = rng.sample_ndist();
+        b(i) = 0.5 + rng.sample_urdist();
+    }
+
+    Hpolytope HP(d, A, b);
+    SparseHpolytope SP(d, A, b);
+    HP.normalize();
+    SP.normalize();
+    CHECK((MT(SP.get_mat()) - HP.get_mat()).norm() < 0.00000001);
+    CHECK(SP.get_mat().nonZeros() <= 2 * d + 3 * cuts);
+
+    NT tol = 0.00000001;
+    VT Ar_d(HP.num_of_hyperplanes()), Av_d(HP.num_of_hyperplanes()),
+       Ar_s(SP.num_of_hyperplanes()), Av_s(SP.num_of_hyperplanes());
+
+    for (int trial = 0; trial < 100; ++trial) {
+        Point r = GetPointInDsphere<Point>::apply(d, NT(0.3), rng);
+        Point v = GetDirection<Point>::apply(d, rng);
+
+        CHECK(HP.is_in(r) == SP.is_in(r));
+        Point q = NT(3) * v;
+        CHECK(HP.is_in(q) == SP.is_in(q));
+
+        std::pair<NT, NT> dense = HP.line_intersect(r, v);
+        std::pair<NT, NT> sparse = SP.line_intersect(r, v);
+        CHECK(std::abs(dense.first - sparse.first) < tol);
+        CHECK(std::abs(dense.second - sparse.second) < tol);
+
+        std::pair<NT, int> dense_pos = HP.line_positive_intersect(r, v, Ar_d, Av_d);
+        std::pair<NT, int> sparse_pos = SP.line_positive_intersect(r, v, Ar_s, Av_s);
+        CHECK(std::abs(dense_pos.first - sparse_pos.first) < tol);
+        CHECK(dense_pos.second == sparse_pos.second);
+
+        // continue the ray after a reflection
+        Point v_d = v, v_s = v;
+        HP.compute_reflection(v_d, r, dense_pos.second);
+        SP.compute_reflection(v_s, r, sparse_pos.second);
+        CHECK((v_d.getCoefficients() - v_s.getCoefficients()).norm() < tol);
+        NT lambda = 0.5 * dense_pos.first;
+        dense_pos = HP.line_positive_intersect(r, v_d, Ar_d, Av_d, lambda);
+        sparse_pos = SP.line_positive_intersect(r, v_s, Ar_s, Av_s, lambda);
+        CHECK(std::abs(dense_pos.first - sparse_pos.first) < tol);
+        CHECK(dense_pos.second == sparse_pos.second);
+
+        // coordinate directions
+        unsigned int coord = rng.sample_uidist(), coord_prev;
+        dense = HP.line_intersect_coord(r, coord, Ar_d);
+        sparse = SP.line_intersect_coord(r, coord, Ar_s);
+        CHECK(std::abs(dense.first - sparse.first) < tol);
+        CHECK(std::abs(dense.second - sparse.second) < tol);
+        for (int step = 0; step < 10; ++step) {
+            Point r_prev = r;
+            r.set_coord(coord, r[coord] + 0.5 * (dense.first + dense.second));
+            coord_prev = coord;
+            coord = rng.sample_uidist();
+            dense = HP.line_intersect_coord(r, r_prev, coord, coord_prev, Ar_d);
+            sparse = SP.line_intersect_coord(r, r_prev, coord, coord_prev, Ar_s);
+            CHECK(std::abs(dense.first - sparse.first) < tol);
+            CHECK(std::abs(dense.second - sparse.second) < tol);
+        }
+    }
+
+    // the accelerated billiard oracles, with A*v updated by A*A^T
+    struct update_parameters
+    {
+        update_parameters()
+                :   facet_prev(0), hit_ball(false), inner_vi_ak(0.0), ball_inner_norm(0.0)
+        {}
+        int facet_prev;
+        bool hit_ball;
+        NT inner_vi_ak;
+        NT ball_inner_norm;
+    } params_d, params_s;
+    MT AA_d = HP.get_AA();
+    typename SparseHpolytope::SpMT AA_s = SP.get_AA();
+    Point r(d), v = GetDirection<Point>::apply(d, rng), v_d = v, v_s = v;
+    std::pair<NT, int> dense_pos = HP.line_first_positive_intersect(r, v_d, Ar_d, Av_d, params_d);
+    std::pair<NT, int> sparse_pos = SP.line_first_positive_intersect(r, v_s, Ar_s, Av_s, params_s);
+    for (int step = 0; step < 50; ++step) {
+        CHECK(std::abs(dense_pos.first - sparse_pos.first) < tol);
+        CHECK(dense_pos.second == sparse_pos.second);
+        NT lambda = 0.995 * dense_pos.first;
+        HP.compute_reflection(v_d, r, params_d);
+        SP.compute_reflection(v_s, r, params_s);
+        dense_pos = HP.line_positive_intersect(r, v_d, Ar_d, Av_d, lambda, AA_d, params_d);
+        sparse_pos = SP.line_positive_intersect(r, v_s, Ar_s, Av_s, lambda, AA_s, params_s);
+    }
+    CHECK((Av_d - Av_s).norm() < tol);
+}
+
+TEST_CASE("sparse_oracles") {
+    call_test_sparse_oracles<double>();
+}
@@ -8,6 +8,7 @@
 
 // Edited by HZ on 11.06.2020 - mute doctest.h
 #include "doctest.h"
+#include <cstdio>
 #include <fstream>
 #include <iostream>
 #include "misc.h"
@@ -28,6 +29,7 @@
 #include "diagnostics/multivariate_psrf.hpp"
 #include "diagnostics/geweke.hpp"
 #include "diagnostics/raftery.hpp"
+#include "sampling/sample_file.hpp"
 
 template
 <
@@ -132,6 +134,61 @@ void call_test_raftery(){
     CHECK(res(0,2) < 6);
 }
 
+// stream samples to a file with a small block, map the file and compare it
+// with the same samples drawn in memory, then run the diagnostics on the map
+template <typename NT>
+void call_test_sample_file(){
+    typedef Cartesian<NT>    Kernel;
+    typedef typename Kernel::Point    Point;
+    typedef HPolytope<Point> Hpolytope;
+    typedef Eigen::Matrix<NT,Eigen::Dynamic,Eigen::Dynamic> MT;
+    typedef Eigen::Matrix<NT,Eigen::Dynamic,1> VT;
+    typedef BoostRandomNumberGenerator<boost::mt19937, NT, 3> RNGType;
+    unsigned int d = 10, walkL = 10, numpoints = 10000, nburns = 10;
+
+    std::cout << "--- Testing a sample file of Billiard Walk and H-cube10" << std::endl;
+    Hpolytope P = generate_cube<Hpolytope>(d, false);
+    P.ComputeInnerBall();
+    Point StartingPoint(d);
+    std::string filename = "sample_file_test.bin";
+
+    {
+        RNGType rng(d);
+        SampleFileWriter<NT> writer(filename, d, 3, "AcceleratedBilliardWalk", 1000 - 1);
+        uniform_sampling_to_file<AcceleratedBilliardWalk>(writer, P, rng, walkL,
+                                                          numpoints, StartingPoint,
+                                                          nburns);
+        CHECK(writer.size() == numpoints);
+    }
+
+    RNGType rng(d);
+    std::list<Point> randPoints;
+    uniform_sampling<AcceleratedBilliardWalk>(randPoints, P, rng, walkL, numpoints,
+                                              StartingPoint, nburns);
+
+    SampleFileReader<NT> reader(filename);
+    CHECK(reader.dimension() == d);
+    CHECK(reader.num_samples() == numpoints);
+    CHECK(reader.header().seed == 3);
+    CHECK(reader.walk() == "AcceleratedBilliardWalk");
+
+    typename SampleFileReader<NT>::SamplesMap samples = reader.samples();
+    unsigned int different = 0, jj = 0;
+    for (auto rpit = randPoints.begin(); rpit != randPoints.end(); rpit++, jj++)
+    {
+        if (samples.col(jj) != (*rpit).getCoefficients()) different++;
+    }
+    CHECK(different == 0);
+    CHECK(reader.samples(numpoints - 1, 1).col(0) == randPoints.back().getCoefficients());
+
+    NT score = multivariate_psrf<NT, VT>(samples);
+    std::cout<<"psrf = "<<score<<std::endl;
+    CHECK(score < 1.1);
+    MT res = perform_raftery<VT>(samples, NT(0.025), NT(0.01), NT(0.95));
+    CHECK(res(0,2) < 6);
+
+    std::remove(filename.c_str());
+}
 
 TEST_CASE("psrf") {
     call_test_psrf<double>();
@@ -144,3 +201,7 @@ TEST_CASE("geweke") {
 TEST_CASE("raftery") {
     call_test_raftery<double>();
 }
+
+TEST_CASE("sample_file") {
+    call_test_sample_file<double>();
+}
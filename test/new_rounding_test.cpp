@@ -21,6 +21,8 @@
 #include "volume/volume_cooling_balls.hpp"
 
 #include "preprocess/min_sampling_covering_ellipsoid_rounding.hpp"
+#include "preprocess/svd_rounding.hpp"
+#include "convex_bodies/sparse_hpolytope.h"
 
 #include "known_polytope_generators.h"
 
@@ -116,8 +118,58 @@ void call_test_skinny_cubes() {
 }
 
 
+template <typename NT>
+void call_test_sparse_skinny_cubes() {
+    typedef Cartesian <NT> Kernel;
+    typedef typename Kernel::Point Point;
+    typedef HPolytope <Point> Hpolytope;
+    typedef SparseHPolytope <Point> SparseHpolytope;
+    Hpolytope HP;
+
+    std::cout << "\n--- Testing rounding of sparse H-skinny_cube5" << std::endl;
+    HP = generate_skinny_cube<Hpolytope>(5);
+    SparseHpolytope P(HP.dimension(), HP.get_mat(), HP.get_vec());
+    rounding_test(P, 0, 3070.64, 3188.25, 3140.6, 3200.0);
+
+    std::cout << "\n--- Testing rounding of sparse H-skinny_cube10" << std::endl;
+    HP = generate_skinny_cube<Hpolytope>(10);
+    P = SparseHpolytope(HP.dimension(), HP.get_mat(), HP.get_vec());
+    rounding_test(P, 0, 122550, 108426, 105003.0, 102400.0);
+}
+
+
+// round with the samples of three chains
+template <typename NT>
+void call_test_svd_rounding_parallel() {
+    typedef Cartesian <NT> Kernel;
+    typedef typename Kernel::Point Point;
+    typedef HPolytope <Point> Hpolytope;
+    typedef typename Hpolytope::MT MT;
+    typedef typename Hpolytope::VT VT;
+    typedef BoostRandomNumberGenerator<boost::mt19937, NT, 5> RNGType;
+
+    std::cout << "\n--- Testing parallel svd rounding of H-skinny_cube10" << std::endl;
+    Hpolytope P = generate_skinny_cube<Hpolytope>(10);
+    RNGType rng(P.dimension());
+
+    std::pair<Point, NT> InnerBall = P.ComputeInnerBall();
+    std::tuple<MT, VT, NT> res = svd_rounding<BilliardWalk, MT, VT>(P, InnerBall, 2, rng, 3);
+
+    NT volume = std::get<2>(res) * volume_cooling_balls<CDHRWalk, RNGType>(P, 0.1, 1).second;
+    test_values(volume, 102400.0, 102400.0);
+}
+
+
 TEST_CASE("round_skinny_cube") {
     call_test_skinny_cubes<double>();
     //call_test_skinny_cubes<float>();
     //call_test_skinny_cubes<long double>();
 }
+
+TEST_CASE("round_sparse_skinny_cube") {
+    call_test_sparse_skinny_cubes<double>();
+}
+
+TEST_CASE("round_skinny_cube_parallel_svd") {
+    call_test_svd_rounding_parallel<double>();
+}
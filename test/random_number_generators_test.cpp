@@ -0,0 +1,156 @@
+// VolEsti (volume computation and sampling library)
+
+// Copyright (c) 2012-2020 Vissarion Fisikopoulos
+// Copyright (c) 2018-2020 Apostolos Chalkis
+
+// Licensed under GNU LGPL.3, see LICENCE file
+
+#include "doctest.h"
+#include <cmath>
+#include <iostream>
+#include <list>
+#include <vector>
+#include "random.hpp"
+#include "random/uniform_int.hpp"
+#include "random/normal_distribution.hpp"
+#include "random/uniform_real_distribution.hpp"
+
+#include "cartesian_geom/cartesian_kernel.h"
+#include "convex_bodies/hpolytope.h"
+#include "generators/boost_random_number_generator.hpp"
+#include "generators/philox_engine.hpp"
+#include "random_walks/random_walks.hpp"
+#include "sampling/sampling.hpp"
+#include "known_polytope_generators.h"
+
+// the known answers of Philox4x32-10 from Random123
+void call_test_philox_known_answers()
+{
+    std::uint32_t counters[3][4] = {{0, 0, 0, 0},
+                                    {0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff},
+                                    {0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}};
+    std::uint32_t keys[3][2] = {{0, 0},
+                                {0xffffffff, 0xffffffff},
+                                {0xa4093822, 0x299f31d0}};
+    std::uint32_t expected[3][4] = {{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8},
+                                    {0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd},
+                                    {0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}};
+
+    for (int t = 0; t < 3; ++t)
+    {
+        std::uint32_t out[4];
+        philox4x32::philox_block(counters[t], keys[t], out);
+        for (int i = 0; i < 4; ++i) CHECK(out[i] == expected[t][i]);
+    }
+}
+
+// discard jumps to the same state as drawing the numbers, and two streams
+// of the same seed are uncorrelated
+void call_test_philox_streams()
+{
+    for (unsigned int n = 0; n < 40; ++n)
+    {
+        philox4x32 drawn(11, 3), jumped(11, 3);
+        for (unsigned int i = 0; i < n; ++i) drawn();
+        jumped.discard(n);
+        CHECK(drawn == jumped);
+        CHECK(drawn() == jumped());
+    }
+
+    typedef BoostRandomNumberGenerator<philox4x32, double> RNGType;
+    RNGType rng0(1), rng1(1);
+    rng0.set_stream(7, 0);
+    rng1.set_stream(7, 1);
+
+    unsigned int n = 100000;
+    double s0 = 0.0, s1 = 0.0, s01 = 0.0, s00 = 0.0, s11 = 0.0;
+    for (unsigned int i = 0; i < n; ++i)
+    {
+        double x = rng0.sample_ndist(), y = rng1.sample_ndist();
+        s0 += x; s1 += y; s01 += x * y; s00 += x * x; s11 += y * y;
+    }
+    double corr = (s01 / n - s0 * s1 / (double(n) * n))
+                  / std::sqrt((s00 / n - s0 * s0 / (double(n) * n))
+                              * (s11 / n - s1 * s1 / (double(n) * n)));
+    std::cout << "correlation of two streams = " << corr << std::endl;
+    CHECK(std::abs(corr) < 0.02);
+}
+
+// the mean and the variance of bulk uniform and normal numbers
+template <typename RNGType>
+void test_bulk_generation(RNGType &rng)
+{
+    unsigned int n = 100001;
+    std::vector<double> u(n), z(n);
+    rng.sample_urdist(u.data(), n);
+    rng.sample_ndist(z.data(), n);
+
+    double mean_u = 0.0, var_u = 0.0, mean_z = 0.0, var_z = 0.0;
+    unsigned int outside = 0;
+    for (unsigned int i = 0; i < n; ++i)
+    {
+        if (u[i] < 0.0 || u[i] >= 1.0) outside++;
+        mean_u += u[i] / n;
+        mean_z += z[i] / n;
+    }
+    for (unsigned int i = 0; i < n; ++i)
+    {
+        var_u += (u[i] - mean_u) * (u[i] - mean_u) / n;
+        var_z += (z[i] - mean_z) * (z[i] - mean_z) / n;
+    }
+    CHECK(outside == 0);
+    CHECK(std::abs(mean_u - 0.5) < 0.01);
+    CHECK(std::abs(var_u - 1.0 / 12.0) < 0.005);
+    CHECK(std::abs(mean_z) < 0.02);
+    CHECK(std::abs(var_z - 1.0) < 0.02);
+}
+
+// parallel sampling with philox streams is reproducible
+void call_test_philox_parallel_sampling()
+{
+    typedef Cartesian<double>    Kernel;
+    typedef typename Kernel::Point    Point;
+    typedef HPolytope<Point> Hpolytope;
+    typedef BoostRandomNumberGenerator<philox4x32, double> RNGType;
+
+    unsigned int d = 10, rnum = 1001, walk_len = 5, nburns = 10;
+    Hpolytope P = generate_cube<Hpolytope>(d, false);
+    P.ComputeInnerBall();
+    Point StartingPoint(d);
+
+    std::list<Point> randPoints1, randPoints2;
+    uniform_sampling_parallel<CDHRWalk, RNGType>(randPoints1, P, walk_len, rnum,
+                                                 StartingPoint, nburns, 4, 7);
+    uniform_sampling_parallel<CDHRWalk, RNGType>(randPoints2, P, walk_len, rnum,
+                                                 StartingPoint, nburns, 4, 7);
+
+    CHECK(randPoints1.size() == rnum);
+    unsigned int outside = 0, different = 0;
+    auto rpit2 = randPoints2.begin();
+    for (auto rpit1 = randPoints1.begin(); rpit1 != randPoints1.end(); rpit1++, rpit2++)
+    {
+        if (P.is_in(*rpit1) == 0) outside++;
+        if ((*rpit1).getCoefficients() != (*rpit2).getCoefficients()) different++;
+    }
+    CHECK(outside == 0);
+    CHECK(different == 0);
+}
+
+TEST_CASE("philox_known_answers") {
+    call_test_philox_known_answers();
+}
+
+TEST_CASE("philox_streams") {
+    call_test_philox_streams();
+}
+
+TEST_CASE("bulk_generation") {
+    BoostRandomNumberGenerator<boost::mt19937, double, 3> rng(1);
+    test_bulk_generation(rng);
+    BoostRandomNumberGenerator<philox4x32, double, 3> philox_rng(1);
+    test_bulk_generation(philox_rng);
+}
+
+TEST_CASE("philox_parallel_sampling") {
+    call_test_philox_parallel_sampling();
+}
@@ -0,0 +1,367 @@
+// VolEsti (volume computation and sampling library)
+
+// Copyright (c) 2012-2020 Vissarion Fisikopoulos
+// Copyright (c) 2018-2020 Apostolos Chalkis
+
+// Licensed under GNU LGPL.3, see LICENCE file
+
+#include "doctest.h"
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+#include "misc.h"
+#include "random.hpp"
+#include "random/uniform_int.hpp"
+#include "random/normal_distribution.hpp"
+#include "random/uniform_real_distribution.hpp"
+
+#include "cartesian_geom/cartesian_kernel.h"
+#include "random_walks/random_walks.hpp"
+#include "convex_bodies/sparse_hpolytope.h"
+#include "known_polytope_generators.h"
+#include "sampling/sampling.hpp"
+#include "misc/thread_pool.hpp"
+#include "sampling/point_matrix.hpp"
+
+#include "diagnostics/multivariate_psrf.hpp"
+
+template <typename NT>
+void call_test_multi_billiard(){
+    typedef Cartesian<NT>    Kernel;
+    typedef typename Kernel::Point    Point;
+    typedef HPolytope<Point> Hpolytope;
+    typedef Eigen::Matrix<NT,Eigen::Dynamic,Eigen::Dynamic> MT;
+    typedef Eigen::Matrix<NT,Eigen::Dynamic,1> VT;
+    typedef BoostRandomNumberGenerator<boost::mt19937, NT, 3> RNGType;
+    typedef MultiBilliardWalk::Walk<Hpolytope, RNGType> Walk;
+    typedef MultiChainRandomPointGenerator<Walk> RandomPointGenerator;
+
+    unsigned int d = 10, n_chains = 20, rnum = 500, walk_len = 1;
+
+    std::cout << "--- Testing multi-chain billiard walk on H-cube10" << std::endl;
+    Hpolytope P = generate_cube<Hpolytope>(d, false);
+    P.ComputeInnerBall();
+
+    RNGType rng(d);
+    MT X = MT::Zero(d, n_chains);
+    std::list<Point> randPoints;
+    PushBackWalkPolicy push_back_policy;
+    RandomPointGenerator::apply(P, X, rnum, walk_len, randPoints,
+                                push_back_policy, rng);
+
+    CHECK(randPoints.size() == n_chains * rnum);
+
+    MT samples(d, randPoints.size());
+    unsigned int jj = 0, outside = 0;
+    for (auto rpit = randPoints.begin(); rpit != randPoints.end(); rpit++, jj++)
+    {
+        if (P.is_in(*rpit) == 0) outside++;
+        samples.col(jj) = (*rpit).getCoefficients();
+    }
+    CHECK(outside == 0);
+
+    NT score = multivariate_psrf<NT, VT>(samples);
+    std::cout << "psrf = " << score << std::endl;
+    CHECK(score < 1.1);
+}
+
+template <typename NT>
+void call_test_parallel_sampling(){
+    typedef Cartesian<NT>    Kernel;
+    typedef typename Kernel::Point    Point;
+    typedef HPolytope<Point> Hpolytope;
+    typedef BoostRandomNumberGenerator<boost::mt19937, NT> RNGType;
+
+    unsigned int d = 10, rnum = 1001, walk_len = 5, nburns = 10;
+    unsigned int n_threads = 4, seed = 7;
+
+    std::cout << "--- Testing parallel sampling with CDHR on H-cube10" << std::endl;
+    Hpolytope P = generate_cube<Hpolytope>(d, false);
+    P.ComputeInnerBall();
+    Point StartingPoint(d);
+
+    std::list<Point> randPoints1, randPoints2;
+    uniform_sampling_parallel<CDHRWalk, RNGType>(randPoints1, P, walk_len, rnum,
+                                                 StartingPoint, nburns,
+                                                 n_threads, seed);
+    uniform_sampling_parallel<CDHRWalk, RNGType>(randPoints2, P, walk_len, rnum,
+                                                 StartingPoint, nburns,
+                                                 n_threads, seed);
+
+    CHECK(randPoints1.size() == rnum);
+    CHECK(randPoints2.size() == rnum);
+
+    unsigned int outside = 0, different = 0;
+    auto rpit2 = randPoints2.begin();
+    for (auto rpit1 = randPoints1.begin(); rpit1 != randPoints1.end(); rpit1++, rpit2++)
+    {
+        if (P.is_in(*rpit1) == 0) outside++;
+        if ((*rpit1).getCoefficients() != (*rpit2).getCoefficients()) different++;
+    }
+    CHECK(outside == 0);
+    CHECK(different == 0);
+
+    // the chains do not depend on the threads that run them
+    ThreadPool pool(0);
+    std::list<Point> randPoints3;
+    uniform_sampling_parallel<CDHRWalk, RNGType>(randPoints3, P, walk_len, rnum,
+                                                 StartingPoint, nburns,
+                                                 n_threads, seed, pool);
+
+    different = 0;
+    auto rpit3 = randPoints3.begin();
+    for (auto rpit1 = randPoints1.begin(); rpit1 != randPoints1.end(); rpit1++, rpit3++)
+    {
+        if ((*rpit1).getCoefficients() != (*rpit3).getCoefficients()) different++;
+    }
+    CHECK(different == 0);
+}
+
+// open nested parallel regions on a pool of three workers and check that
+// every task runs once, that at most four threads (the workers and the
+// calling thread) are busy at any time and that exceptions reach the caller
+void call_test_thread_pool()
+{
+    ThreadPool pool(3);
+    unsigned int num_tasks = 50, num_inner_tasks = 20;
+    std::vector<std::atomic<unsigned int>> counts(num_tasks * num_inner_tasks);
+    for (auto& count : counts) count = 0;
+    std::atomic<unsigned int> busy(0), max_busy(0);
+
+    pool.parallel_for(num_tasks, 4, [&](unsigned int i)
+    {
+        pool.parallel_for(num_inner_tasks, 4, [&](unsigned int j)
+        {
+            unsigned int b = ++busy;
+            unsigned int m = max_busy;
+            while (b > m && !max_busy.compare_exchange_weak(m, b)) {}
+            ++counts[i * num_inner_tasks + j];
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+            --busy;
+        });
+    });
+
+    unsigned int wrong = 0;
+    for (auto& count : counts) if (count != 1) wrong++;
+    CHECK(wrong == 0);
+    CHECK(max_busy <= 4);
+
+    bool thrown = false;
+    try
+    {
+        pool.parallel_for(num_tasks, 4, [&](unsigned int i)
+        {
+            if (i == 7) throw std::runtime_error("task failed");
+        });
+    }
+    catch (std::runtime_error const&)
+    {
+        thrown = true;
+    }
+    CHECK(thrown);
+}
+
+// the directions of a buffer are unit vectors with zero mean and they follow
+// a change of the dimension
+template <typename NT>
+void call_test_direction_buffer()
+{
+    typedef Cartesian<NT>    Kernel;
+    typedef typename Kernel::Point    Point;
+    typedef Eigen::Matrix<NT,Eigen::Dynamic,1> VT;
+    typedef BoostRandomNumberGenerator<boost::mt19937, NT, 3> RNGType;
+
+    unsigned int d = 5, num_directions = 10000;
+    RNGType rng(d);
+    DirectionBuffer<Point> directions(16);
+    Point v(d);
+    VT mean = VT::Zero(d);
+    unsigned int not_unit = 0;
+
+    for (unsigned int i = 0; i < num_directions; ++i)
+    {
+        directions.next(d, rng, v);
+        if (std::abs(v.length() - NT(1)) > 1e-10) not_unit++;
+        mean += v.getCoefficients() / NT(num_directions);
+    }
+    std::cout << "mean of the directions = " << mean.transpose() << std::endl;
+    CHECK(not_unit == 0);
+    CHECK(mean.norm() < 0.05);
+
+    Point w(d + 2);
+    directions.next(d + 2, rng, w);
+    CHECK(std::abs(w.length() - NT(1)) < 1e-10);
+}
+
+// a PointMatrix holds the same points as a std::list, its batch membership
+// agrees with is_in and its matrix view feeds the diagnostics
+template <typename NT>
+void call_test_point_matrix()
+{
+    typedef Cartesian<NT>    Kernel;
+    typedef typename Kernel::Point    Point;
+    typedef HPolytope<Point> Hpolytope;
+    typedef Ball<Point> BallType;
+    typedef Eigen::Matrix<NT,Eigen::Dynamic,1> VT;
+    typedef BoostRandomNumberGenerator<boost::mt19937, NT, 3> RNGType;
+
+    unsigned int d = 10, num_points = 1000;
+    Hpolytope P = generate_cube<Hpolytope>(d, false);
+    Point center(d);
+    BallType B(center, NT(3));
+    RNGType rng(d);
+
+    std::list<Point> list_points;
+    PointMatrix<Point> matrix_points(d, 4);
+    for (unsigned int i = 0; i < num_points; ++i)
+    {
+        Point p = GetPointInDsphere<Point>::apply(d, NT(2), rng);
+        list_points.push_back(p);
+        matrix_points.push_back(p);
+    }
+    CHECK(matrix_points.size() == num_points);
+
+    unsigned int different = 0, wrong_hpoly = 0, wrong_ball = 0;
+    PointsInBody<Hpolytope, PointMatrix<Point> > in_hpoly(P, matrix_points);
+    PointsInBody<BallType, PointMatrix<Point> > in_ball(B, matrix_points);
+    auto mpit = matrix_points.begin();
+    for (auto lpit = list_points.begin(); lpit != list_points.end(); ++lpit, ++mpit)
+    {
+        if ((*lpit).getCoefficients() != mpit->getCoefficients()) different++;
+        if (in_hpoly.next() != (P.is_in(*lpit) == -1)) wrong_hpoly++;
+        if (in_ball.next() != (B.is_in(*lpit) == -1)) wrong_ball++;
+    }
+    CHECK(mpit == matrix_points.end());
+    CHECK(different == 0);
+    CHECK(wrong_hpoly == 0);
+    CHECK(wrong_ball == 0);
+    CHECK(matrix_points.matrix().col(num_points - 1) == list_points.back().getCoefficients());
+
+    list_points.clear();
+    matrix_points.clear();
+    CHECK(matrix_points.empty());
+    P.ComputeInnerBall();
+    Point StartingPoint(d);
+    uniform_sampling<CDHRWalk>(matrix_points, P, rng, 5, 5000, StartingPoint, 10);
+    CHECK(matrix_points.size() == 5000);
+
+    NT score = multivariate_psrf<NT, VT>(matrix_points.matrix());
+    std::cout << "psrf = " << score << std::endl;
+    CHECK(score < 1.1);
+}
+
+template <typename NT, typename WalkType>
+void call_test_fixed_dimension(){
+    typedef Cartesian<NT, 5>    Kernel;
+    typedef typename Kernel::Point    Point;
+    typedef HPolytope<Point> Hpolytope;
+    typedef Eigen::Matrix<NT,Eigen::Dynamic,Eigen::Dynamic> MT;
+    typedef Eigen::Matrix<NT,Eigen::Dynamic,1> VT;
+    typedef BoostRandomNumberGenerator<boost::mt19937, NT, 3> RNGType;
+
+    unsigned int d = 5, rnum = 5000, walk_len = 5, nburns = 100;
+
+    Hpolytope P = generate_cube<Hpolytope>(d, false);
+    P.ComputeInnerBall();
+
+    RNGType rng(d);
+    Point StartingPoint(d);
+    std::list<Point> randPoints;
+    uniform_sampling<WalkType>(randPoints, P, rng, walk_len, rnum,
+                               StartingPoint, nburns);
+
+    CHECK(randPoints.size() == rnum);
+
+    MT samples(d, randPoints.size());
+    unsigned int jj = 0, outside = 0;
+    for (auto rpit = randPoints.begin(); rpit != randPoints.end(); rpit++, jj++)
+    {
+        if (P.is_in(*rpit) == 0) outside++;
+        samples.col(jj) = (*rpit).getCoefficients();
+    }
+    CHECK(outside == 0);
+
+    NT score = multivariate_psrf<NT, VT>(samples);
+    std::cout << "psrf = " << score << std::endl;
+    CHECK(score < 1.1);
+}
+
+template <typename NT, typename WalkType>
+void call_test_sparse_hpolytope(){
+    typedef Cartesian<NT>    Kernel;
+    typedef typename Kernel::Point    Point;
+    typedef HPolytope<Point> Hpolytope;
+    typedef SparseHPolytope<Point> SparseHpolytope;
+    typedef Eigen::Matrix<NT,Eigen::Dynamic,Eigen::Dynamic> MT;
+    typedef Eigen::Matrix<NT,Eigen::Dynamic,1> VT;
+    typedef BoostRandomNumberGenerator<boost::mt19937, NT, 3> RNGType;
+
+    unsigned int d = 10, rnum = 5000, walk_len = 5, nburns = 100;
+
+    Hpolytope HP = generate_cube<Hpolytope>(d, false);
+    SparseHpolytope P(d, HP.get_mat(), HP.get_vec());
+    std::pair<Point, NT> InnerBall = P.ComputeInnerBall();
+    CHECK(std::abs(InnerBall.second - NT(1)) < 0.00001);
+
+    RNGType rng(d);
+    Point StartingPoint(d);
+    std::list<Point> randPoints;
+    uniform_sampling<WalkType>(randPoints, P, rng, walk_len, rnum,
+                               StartingPoint, nburns);
+
+    CHECK(randPoints.size() == rnum);
+
+    MT samples(d, randPoints.size());
+    unsigned int jj = 0, outside = 0;
+    for (auto rpit = randPoints.begin(); rpit != randPoints.end(); rpit++, jj++)
+    {
+        if (P.is_in(*rpit) == 0) outside++;
+        samples.col(jj) = (*rpit).getCoefficients();
+    }
+    CHECK(outside == 0);
+
+    NT score = multivariate_psrf<NT, VT>(samples);
+    std::cout << "psrf = " << score << std::endl;
+    CHECK(score < 1.1);
+}
+
+TEST_CASE("multi_billiard") {
+    call_test_multi_billiard<double>();
+}
+
+TEST_CASE("parallel_sampling") {
+    call_test_parallel_sampling<double>();
+}
+
+TEST_CASE("thread_pool") {
+    call_test_thread_pool();
+}
+
+TEST_CASE("direction_buffer") {
+    call_test_direction_buffer<double>();
+}
+
+TEST_CASE("point_matrix") {
+    call_test_point_matrix<double>();
+}
+
+TEST_CASE("fixed_dimension") {
+    std::cout << "--- Testing sampling from H-cube5 with fixed-size points" << std::endl;
+    call_test_fixed_dimension<double, BallWalk>();
+    call_test_fixed_dimension<double, CDHRWalk>();
+    call_test_fixed_dimension<double, RDHRWalk>();
+    call_test_fixed_dimension<double, BilliardWalk>();
+    call_test_fixed_dimension<double, AcceleratedBilliardWalk>();
+}
+
+TEST_CASE("sparse_hpolytope") {
+    std::cout << "--- Testing sampling from a sparse H-cube10" << std::endl;
+    call_test_sparse_hpolytope<double, BallWalk>();
+    call_test_sparse_hpolytope<double, CDHRWalk>();
+    call_test_sparse_hpolytope<double, RDHRWalk>();
+    call_test_sparse_hpolytope<double, BilliardWalk>();
+    call_test_sparse_hpolytope<double, AcceleratedBilliardWalk>();
+}
@@ -260,6 +260,31 @@ void call_test_skinny_cube() {
     //test_volume(P, 104857600, 104857600.0);
 }
 
+template <typename NT>
+void call_test_parallel() {
+    typedef Cartesian<NT>    Kernel;
+    typedef typename Kernel::Point    Point;
+    typedef BoostRandomNumberGenerator<boost::mt19937, NT, 3> RNGType;
+
+    typedef HPolytope<Point> Hpolytope;
+    Hpolytope P;
+    NT e = 0.1, volume;
+    unsigned int walk_len = 11, n_threads = 4;
+
+    std::cout << "--- Testing volume of H-cube10 with 4 threads" << std::endl;
+    P = generate_cube<Hpolytope>(10, false);
+    volume = volume_cooling_balls<CDHRWalk, RNGType>(P, e, walk_len, n_threads).second;
+    test_values(volume, 1024.0, 1024.0);
+
+    volume = volume_cooling_balls<BilliardWalk, RNGType>(P, e, walk_len, n_threads).second;
+    test_values(volume, 1024.0, 1024.0);
+
+    std::cout << "--- Testing volume of H-simplex10 with 4 threads" << std::endl;
+    P = generate_simplex<Hpolytope>(10, false);
+    volume = volume_cooling_balls<CDHRWalk, RNGType>(P, e, walk_len, n_threads).second;
+    test_values(volume, 1.0 / factorial(10.0), 1.0 / factorial(10.0));
+}
+
 
 TEST_CASE("cube") {
     call_test_cube<double>();
@@ -286,3 +311,7 @@ TEST_CASE("skinny_cube") {
     call_test_skinny_cube<double>();
 }
 
+
+TEST_CASE("parallel") {
+    call_test_parallel<double>();
+}
@@ -172,8 +172,8 @@ void call_test_birk() {
     test_volume(P,
                 5.71076 * std::pow(10,-13),
                 9.48912 * std::pow(10,-13),
-                6.96476e-13,
-                6.96476e-13,
+                6.82569e-13,
+                6.82569e-13,
                 0.0000000000009455459196);
 }
 
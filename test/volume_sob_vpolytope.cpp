@@ -28,7 +28,8 @@ NT factorial(NT n)
 }
 
 template <class Polytope>
-void test_volume(Polytope &P, double const& expected, double const& exact)
+void test_volume(Polytope &P, double const& expected, double const& exact,
+                 unsigned int const& n_threads = 1)
 {
     typedef typename Polytope::PointType Point;
     typedef typename Point::FT NT;
@@ -42,7 +43,8 @@ void test_volume(Polytope &P, double const& expected, double const& exact)
     typedef BoostRandomNumberGenerator<boost::mt19937, NT, 3> RNGType;
 
     Polytope P1(P.dimension(), P.get_mat(), P.get_vec());
-    NT volume = volume_sequence_of_balls<RDHRWalk, RNGType>(P1, e, walk_len);
+    NT volume = volume_sequence_of_balls<RDHRWalk, RNGType>(P1, e, walk_len,
+                                                            n_threads);
 
     //TODO: test other walks
 
@@ -125,6 +127,16 @@ void call_test_simplex() {
 //    test_volume(P, 2.99056 * std::pow(10,-7), 1.0 / factorial(10.0));
 
 }
+template <typename NT>
+void call_test_parallel() {
+    typedef Cartesian<NT>    Kernel;
+    typedef typename Kernel::Point    Point;
+    typedef VPolytope<Point> Vpolytope;
+
+    std::cout << "--- Testing volume of V-cross5 with 4 threads" << std::endl;
+    Vpolytope P1 = generate_cross<Vpolytope>(5, true);
+    test_volume(P1, 0.266666667, 0.266666667, 4);
+}
 
 
 TEST_CASE("cube") {
@@ -139,3 +151,7 @@ TEST_CASE("cross") {
 TEST_CASE("simplex") {
     call_test_simplex<double>();
 }
+
+TEST_CASE("parallel") {
+    call_test_parallel<double>();
+}
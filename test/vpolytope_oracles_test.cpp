@@ -0,0 +1,339 @@
+// VolEsti (volume computation and sampling library)
+
+// Copyright (c) 2012-2020 Vissarion Fisikopoulos
+// Copyright (c) 2018-2020 Apostolos Chalkis
+
+// Licensed under GNU LGPL.3, see LICENCE file
+
+#include "doctest.h"
+#include <chrono>
+#include <iostream>
+#include <vector>
+#include "random.hpp"
+#include "random/uniform_int.hpp"
+#include "random/normal_distribution.hpp"
+#include "random/uniform_real_distribution.hpp"
+
+#include "cartesian_geom/cartesian_kernel.h"
+#include "convex_bodies/hpolytope.h"
+#include "convex_bodies/vpolytope.h"
+#include "convex_bodies/zpolytope.h"
+#include "convex_bodies/vpolyintersectvpoly.h"
+#include "generators/boost_random_number_generator.hpp"
+#include "random_walks/coordinate_oracle_state.hpp"
+#include "sampling/sphere.hpp"
+#include "known_polytope_generators.h"
+#include "v_polytopes_generators.h"
+#include "z_polytopes_generators.h"
+
+// compare the oracles of P, that keep their LPs between the calls,
+// with the oracles that build a new LP at each call
+template <class Polytope, class RNGType>
+void test_persistent_lp(Polytope& P, bool zonotope, RNGType& rng)
+{
+    typedef typename Polytope::PointType Point;
+    typedef typename Point::FT NT;
+    typedef typename Polytope::MT MT;
+    typedef typename Polytope::VT VT;
+
+    unsigned int d = P.dimension();
+    NT tol = 0.00000001;
+    std::vector<REAL> row(P.num_of_vertices() + 1), conv_comb(P.num_of_vertices() + 1);
+    std::vector<int> colno(P.num_of_vertices() + 1);
+    VT Ar, Av;
+
+    std::pair<Point, NT> InnerBall = P.ComputeInnerBall();
+
+    for (int trial = 0; trial < 100; ++trial) {
+        MT V = P.get_mat();
+        Point r = GetPointInDsphere<Point>::apply(d, InnerBall.second, rng);
+        r += InnerBall.first;
+        Point v = GetDirection<Point>::apply(d, rng);
+
+        std::pair<NT, NT> res = P.line_intersect(r, v), fresh;
+        if (zonotope) {
+            fresh = intersect_line_zono(V, r, v, row.data(), colno.data());
+        } else {
+            fresh = intersect_double_line_Vpoly<NT>(V, r, v, row.data(), colno.data());
+        }
+        CHECK(std::abs(res.first - fresh.first) < tol);
+        CHECK(std::abs(res.second - fresh.second) < tol);
+
+        NT lambda = P.line_positive_intersect(r, v, Ar, Av).first;
+        CHECK(std::abs(lambda - intersect_line_Vpoly(V, r, v, conv_comb.data(), row.data(),
+                                                     colno.data(), false, zonotope)) < tol);
+
+        for (NT t : {NT(0.5), NT(2)}) {
+            Point q = r + (t * res.second) * v;
+            bool in = zonotope ? memLP_Zonotope(V, q, row.data(), colno.data())
+                               : memLP_Vpoly(V, q, row.data(), colno.data());
+            CHECK((P.is_in(q) == -1) == in);
+        }
+
+        // a copy builds its own LPs
+        Polytope P2 = P;
+        res = P2.line_intersect(r, v);
+        CHECK(std::abs(res.first - fresh.first) < tol);
+        CHECK(std::abs(res.second - fresh.second) < tol);
+
+        // the LPs are rebuilt when the polytope changes
+        if (trial == 50) {
+            MT T = MT::Identity(d, d);
+            T(0, 0) = 2;
+            P.linear_transformIt(T);
+            InnerBall = P.ComputeInnerBall();
+        }
+    }
+}
+
+template <typename NT>
+void call_test_persistent_lp()
+{
+    typedef Cartesian<NT>    Kernel;
+    typedef typename Kernel::Point    Point;
+    typedef VPolytope<Point> Vpolytope;
+    typedef Zonotope<Point> zonotope;
+    typedef BoostRandomNumberGenerator<boost::mt19937, NT, 3> RNGType;
+    RNGType rng(5);
+
+    std::cout << "--- Testing persistent LP oracles on random V-polytope 5-30" << std::endl;
+    Vpolytope VP = random_vpoly<Vpolytope, boost::mt19937>(5, 30, 127);
+    test_persistent_lp(VP, false, rng);
+
+    std::cout << "--- Testing persistent LP oracles on random zonotope 5-10" << std::endl;
+    zonotope ZP = gen_zonotope_uniform<zonotope, boost::mt19937>(5, 10, 127);
+    test_persistent_lp(ZP, true, rng);
+}
+
+TEST_CASE("persistent_lp") {
+    call_test_persistent_lp<double>();
+}
+
+// follow a billiard trajectory in a zonotope and compare the active-set oracle,
+// and the facet normal that it returns, with the LP
+template <typename NT>
+void call_test_zonotope_active_set(int const& d, int const& m)
+{
+    typedef Cartesian<NT>    Kernel;
+    typedef typename Kernel::Point    Point;
+    typedef Zonotope<Point> zonotope;
+    typedef typename zonotope::MT MT;
+    typedef typename zonotope::VT VT;
+    typedef BoostRandomNumberGenerator<boost::mt19937, NT, 3> RNGType;
+    RNGType rng(d);
+
+    std::cout << "--- Testing active-set oracle on random zonotope " << d << "-" << m << std::endl;
+    zonotope Z = gen_zonotope_uniform<zonotope, boost::mt19937>(d, m, 127);
+    Z.ComputeInnerBall();
+    MT V = Z.get_mat();
+    NT tol = 0.00000001;
+    std::vector<REAL> row(m + 1), conv_comb(m + 1);
+    std::vector<int> colno(m + 1);
+    VT Ar, Av;
+
+    Point p = Z.InnerBall().first, v = GetDirection<Point>::apply(d, rng);
+    for (int step = 0; step < 200; ++step) {
+        NT lambda = Z.line_positive_intersect(p, v, Ar, Av).first;
+        NT lp_lambda = intersect_line_Vpoly(V, p, v, conv_comb.data(), row.data(),
+                                            colno.data(), false, true);
+        CHECK(std::abs(lambda - lp_lambda) < tol * std::max(NT(1), lp_lambda));
+
+        // the facet normal from the generators of the facet
+        MT F(d - 1, d);
+        int count = 0;
+        for (int j = 0; j < m && count < d - 1; ++j) {
+            if (std::abs(conv_comb[j]) < 1.0 - 0.0000001) F.row(count++) = V.row(j);
+        }
+        CHECK(count == d - 1);
+        VT a = F.fullPivLu().kernel();
+        Point q = p + lp_lambda * v;
+        if (q.getCoefficients().dot(a) < 0.0) a *= -1.0;
+        a.normalize();
+
+        Point v_lp = v;
+        v_lp += (-2.0 * v.dot(a)) * a;
+        Z.compute_reflection(v, q, 0);
+        CHECK((v.getCoefficients() - v_lp.getCoefficients()).norm() < 0.000001);
+
+        p = q + (-0.05 * lp_lambda) * v_lp;
+        if (step % 10 == 0) {
+            std::pair<NT, NT> res = Z.line_intersect(p, v);
+            std::pair<NT, NT> lp_res = intersect_line_zono(V, p, v, row.data(), colno.data());
+            CHECK(std::abs(res.first - lp_res.first) < tol * std::max(NT(1), lp_res.first));
+            CHECK(std::abs(res.second - lp_res.second) < tol * std::max(NT(1), -lp_res.second));
+        }
+    }
+}
+
+TEST_CASE("zonotope_active_set") {
+    call_test_zonotope_active_set<double>(5, 10);
+    call_test_zonotope_active_set<double>(10, 30);
+}
+
+// add to the vertices of the cube points in its interior, a point on an edge
+// and copies of two vertices, then check that all of them are removed
+template <typename NT>
+void call_test_remove_redundant_points()
+{
+    typedef Cartesian<NT>    Kernel;
+    typedef typename Kernel::Point    Point;
+    typedef VPolytope<Point> Vpolytope;
+    typedef typename Vpolytope::MT MT;
+    typedef typename Vpolytope::VT VT;
+    typedef BoostRandomNumberGenerator<boost::mt19937, NT, 3> RNGType;
+    RNGType rng(4);
+
+    unsigned int d = 4;
+    Vpolytope cube = generate_cube<Vpolytope>(d, true);
+    MT V0 = cube.get_mat(), V(V0.rows() + 53, d);
+    V.topRows(V0.rows()) = V0;
+    for (int i = 0; i < 50; ++i) {
+        for (unsigned int j = 0; j < d; ++j) V(V0.rows() + i, j) = 1.8 * rng.sample_urdist() - 0.9;
+    }
+    V.row(V0.rows() + 50) = 0.5 * (V0.row(0) + V0.row(1));
+    V.row(V0.rows() + 51) = V0.row(3);
+    V.row(V0.rows() + 52) = V0.row(7);
+
+    std::cout << "--- Testing removal of redundant points of 4-cube" << std::endl;
+    for (unsigned int n_threads : {1u, 4u}) {
+        Vpolytope P(d, V, VT::Ones(V.rows()));
+        CHECK(P.remove_redundant_points(n_threads) == 53);
+        CHECK(P.num_of_vertices() == V0.rows());
+
+        MT V1 = P.get_mat();
+        for (int i = 0; i < V0.rows(); ++i) {
+            CHECK((V1.row(i) - V0.row(i)).norm() == 0);
+        }
+        CHECK(P.remove_redundant_points(n_threads) == 0);
+    }
+}
+
+TEST_CASE("remove_redundant_points") {
+    call_test_remove_redundant_points<double>();
+}
+
+// compare the oracles of the intersection of three V-polytopes, evaluated on
+// one and on three threads, with the oracles of the V-polytopes
+template <typename NT>
+void call_test_intersection_of_vpolytopes()
+{
+    typedef Cartesian<NT>    Kernel;
+    typedef typename Kernel::Point    Point;
+    typedef VPolytope<Point> Vpolytope;
+    typedef BoostRandomNumberGenerator<boost::mt19937, NT, 3> RNGType;
+    typedef IntersectionOfVpoly<Vpolytope, RNGType> VpIntVp;
+    RNGType rng(4);
+
+    std::cout << "--- Testing intersection of three random V-polytopes 4-15" << std::endl;
+    std::vector<Vpolytope> Ps;
+    Ps.push_back(random_vpoly<Vpolytope, boost::mt19937>(4, 15, 127));
+    Ps.push_back(random_vpoly<Vpolytope, boost::mt19937>(4, 15, 211));
+    Ps.push_back(random_vpoly<Vpolytope, boost::mt19937>(4, 15, 307));
+
+    VpIntVp P(Ps, 5), P2(Ps[0], Ps[1], 5), P2v({Ps[0], Ps[1]}, 5);
+    CHECK(P.is_feasible());
+    std::pair<Point, NT> InnerBall = P.ComputeInnerBall();
+    VpIntVp Pt = P;
+    Pt.set_num_threads(3);
+
+    for (int trial = 0; trial < 50; ++trial) {
+        Point r = GetPointInDsphere<Point>::apply(4, InnerBall.second, rng);
+        r += InnerBall.first;
+        Point v = GetDirection<Point>::apply(4, rng);
+
+        std::pair<NT, NT> res = P.line_intersect(r, v), rest = Pt.line_intersect(r, v);
+        std::pair<NT, NT> expected = Ps[0].line_intersect(r, v);
+        for (int i = 1; i < 3; ++i) {
+            std::pair<NT, NT> resi = Ps[i].line_intersect(r, v);
+            expected.first = std::min(expected.first, resi.first);
+            expected.second = std::max(expected.second, resi.second);
+        }
+        NT tol = 0.00000001;
+        CHECK(std::abs(res.first - expected.first) < tol);
+        CHECK(std::abs(res.second - expected.second) < tol);
+        CHECK(std::abs(rest.first - expected.first) < tol);
+        CHECK(std::abs(rest.second - expected.second) < tol);
+
+        std::pair<NT, int> pos = P.line_positive_intersect(r, v);
+        CHECK(std::abs(pos.first - Pt.line_positive_intersect(r, v).first) < tol);
+        CHECK(std::abs(pos.first - expected.first) < tol);
+        CHECK(std::abs(Ps[pos.second - 1].line_positive_intersect(r, v).first - pos.first) < tol);
+
+        CHECK(P.is_in(r + (0.5 * pos.first) * v) == -1);
+        CHECK(Pt.is_in(r + (0.5 * pos.first) * v) == -1);
+        CHECK(P.is_in(r + (2.0 * pos.first) * v) == 0);
+        CHECK(Pt.is_in(r + (2.0 * pos.first) * v) == 0);
+
+        std::pair<NT, NT> res2 = P2.line_intersect(r, v), res2v = P2v.line_intersect(r, v);
+        CHECK(std::abs(res2.first - res2v.first) < tol);
+        CHECK(std::abs(res2.second - res2v.second) < tol);
+    }
+}
+
+TEST_CASE("intersection_of_vpolytopes") {
+    call_test_intersection_of_vpolytopes<double>();
+}
+
+// move a point along random coordinates, drawn from a few ones to repeat them
+// often, and compare the chords of the coordinate oracle state with the chords
+// of the oracle
+template <class Polytope, class RNGType>
+void test_coordinate_oracle_state(Polytope& P, RNGType& rng)
+{
+    typedef typename Polytope::PointType Point;
+    typedef typename Point::FT NT;
+    typedef typename Polytope::VT VT;
+
+    NT tol = 0.00000001;
+    unsigned int d = P.dimension();
+    boost::random::uniform_int_distribution<> uidist(0, 2);
+    boost::random::uniform_real_distribution<> urdist(0, 1);
+    VT lamdas;
+    Point p(d);
+    CoordinateOracleState<Polytope> state;
+
+    std::pair<NT, NT> chord = state.initialize(P, p, 0);
+    unsigned int rand_coord = 0;
+    for (unsigned int i = 0; i < 200; ++i)
+    {
+        lamdas.setZero(P.num_of_hyperplanes());
+        std::pair<NT, NT> exact = P.line_intersect_coord(p, rand_coord, lamdas);
+        CHECK(std::abs(chord.first - exact.first) < tol);
+        CHECK(std::abs(chord.second - exact.second) < tol);
+
+        p.set_coord(rand_coord, p[rand_coord] + chord.first + urdist(rng)
+                    * (chord.second - chord.first));
+        rand_coord = uidist(rng);
+        chord = state.line_intersect_coord(P, p, rand_coord);
+    }
+}
+
+template <typename NT>
+void call_test_coordinate_oracle_state()
+{
+    typedef Cartesian<NT>    Kernel;
+    typedef typename Kernel::Point    Point;
+    typedef HPolytope<Point> Hpolytope;
+    typedef VPolytope<Point> Vpolytope;
+    typedef Zonotope<Point> zonotope;
+    typedef BoostRandomNumberGenerator<boost::mt19937, NT, 3> RNGType;
+    typedef IntersectionOfVpoly<Vpolytope, RNGType> VpIntVp;
+    boost::mt19937 rng(5);
+
+    std::cout << "--- Testing the coordinate oracle state" << std::endl;
+    Hpolytope HP = generate_cube<Hpolytope>(5, false);
+    test_coordinate_oracle_state(HP, rng);
+
+    Vpolytope VP = generate_cross<Vpolytope>(5, true);
+    test_coordinate_oracle_state(VP, rng);
+
+    zonotope ZP = gen_zonotope_uniform<zonotope, boost::mt19937>(5, 10, 127);
+    test_coordinate_oracle_state(ZP, rng);
+
+    VpIntVp IP(generate_cube<Vpolytope>(5, true), generate_cross<Vpolytope>(5, true));
+    test_coordinate_oracle_state(IP, rng);
+}
+
+TEST_CASE("coordinate_oracle_state") {
+    call_test_coordinate_oracle_state<double>();
+}